@@ -0,0 +1,403 @@
+#include "BlurEngine.h"
+#include <QElapsedTimer>
+#include <QRandomGenerator>
+#include <QThread>
+#include <QtConcurrent/QtConcurrent>
+#include <QDebug>
+#include <cmath>   // For std::sqrt
+#include <cstring> // For std::memcpy
+#include <vector>
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define BLUR_HAS_SSE2 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h> // For __cpuid/__cpuidex
+#define BLUR_TARGET_AVX2
+#else
+#define BLUR_TARGET_AVX2 __attribute__((target("avx2")))
+#endif
+#else
+#define BLUR_HAS_SSE2 0
+#endif
+
+namespace {
+
+// Below this many pixels a pass runs on the calling thread; splitting costs more than it saves
+const int PARALLEL_THRESHOLD_PIXELS = 256 * 256;
+
+// Every kernel rounds the same way, (sum * inv + 0.5) truncated, so all paths give identical bytes.
+// Each pixel's four channels are summed separately; the image is premultiplied, so no unpremultiply.
+
+using HorizontalFn = void (*)(const uchar* src, uchar* dst, int width, qsizetype bpl, int rowBegin, int rowEnd, int radius);
+using VerticalFn = void (*)(const uchar* src, uchar* dst, int height, qsizetype bpl, int byteBegin, int byteEnd, int radius);
+
+void horizontalScalar(const uchar* src, uchar* dst, int width, qsizetype bpl, int rowBegin, int rowEnd, int radius)
+{
+    const float inv = 1.0f / (2 * radius + 1);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const uchar* in = src + y * bpl;
+        uchar* out = dst + y * bpl;
+        quint32 sum[4] = {0, 0, 0, 0};
+        for (int i = -radius; i <= radius; ++i) {
+            const uchar* p = in + 4 * qBound(0, i, width - 1); // Edges repeat the border pixel
+            for (int c = 0; c < 4; ++c) sum[c] += p[c];
+        }
+        for (int x = 0; x < width; ++x) {
+            for (int c = 0; c < 4; ++c) out[4 * x + c] = static_cast<uchar>(sum[c] * inv + 0.5f);
+            const uchar* add = in + 4 * qMin(x + radius + 1, width - 1);
+            const uchar* sub = in + 4 * qMax(x - radius, 0);
+            for (int c = 0; c < 4; ++c) sum[c] += add[c] - sub[c];
+        }
+    }
+}
+
+// Sweeps a row of running column sums over bytes [byteBegin, byteEnd) of every row
+void verticalScalar(const uchar* src, uchar* dst, int height, qsizetype bpl, int byteBegin, int byteEnd, int radius)
+{
+    const float inv = 1.0f / (2 * radius + 1);
+    const int n = byteEnd - byteBegin;
+    std::vector<quint32> acc(n, 0);
+    for (int i = -radius; i <= radius; ++i) {
+        const uchar* row = src + qBound(0, i, height - 1) * bpl + byteBegin;
+        for (int k = 0; k < n; ++k) acc[k] += row[k];
+    }
+    for (int y = 0; y < height; ++y) {
+        uchar* out = dst + y * bpl + byteBegin;
+        const uchar* add = src + qMin(y + radius + 1, height - 1) * bpl + byteBegin;
+        const uchar* sub = src + qMax(y - radius, 0) * bpl + byteBegin;
+        for (int k = 0; k < n; ++k) {
+            out[k] = static_cast<uchar>(acc[k] * inv + 0.5f);
+            acc[k] += add[k] - sub[k];
+        }
+    }
+}
+
+#if BLUR_HAS_SSE2
+
+inline __m128i loadPixelSse2(const uchar* p)
+{
+    int bits;
+    std::memcpy(&bits, p, 4);
+    const __m128i zero = _mm_setzero_si128();
+    return _mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(bits), zero), zero); // 4 x int32
+}
+
+inline void storePixelSse2(uchar* p, __m128i sum, __m128 inv, __m128 half)
+{
+    __m128i q = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(sum), inv), half));
+    q = _mm_packs_epi32(q, q);
+    q = _mm_packus_epi16(q, q);
+    const int bits = _mm_cvtsi128_si32(q);
+    std::memcpy(p, &bits, 4);
+}
+
+// One pixel (four channel sums) per vector; the sliding window itself is serial along the row
+void horizontalSse2(const uchar* src, uchar* dst, int width, qsizetype bpl, int rowBegin, int rowEnd, int radius)
+{
+    const __m128 inv = _mm_set1_ps(1.0f / (2 * radius + 1));
+    const __m128 half = _mm_set1_ps(0.5f);
+    for (int y = rowBegin; y < rowEnd; ++y) {
+        const uchar* in = src + y * bpl;
+        uchar* out = dst + y * bpl;
+        __m128i sum = _mm_setzero_si128();
+        for (int i = -radius; i <= radius; ++i) {
+            sum = _mm_add_epi32(sum, loadPixelSse2(in + 4 * qBound(0, i, width - 1)));
+        }
+        for (int x = 0; x < width; ++x) {
+            storePixelSse2(out + 4 * x, sum, inv, half);
+            sum = _mm_add_epi32(sum, _mm_sub_epi32(loadPixelSse2(in + 4 * qMin(x + radius + 1, width - 1)),
+                                                   loadPixelSse2(in + 4 * qMax(x - radius, 0))));
+        }
+    }
+}
+
+// Sixteen bytes (four pixels) per step: the column sums are independent, so this vectorizes fully
+void verticalSse2(const uchar* src, uchar* dst, int height, qsizetype bpl, int byteBegin, int byteEnd, int radius)
+{
+    const float invScalar = 1.0f / (2 * radius + 1);
+    const __m128 inv = _mm_set1_ps(invScalar);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128i zero = _mm_setzero_si128();
+    const int n = byteEnd - byteBegin;
+    const int vectorBytes = n & ~15;
+    std::vector<quint32> acc(n, 0);
+
+    for (int i = -radius; i <= radius; ++i) {
+        const uchar* row = src + qBound(0, i, height - 1) * bpl + byteBegin;
+        for (int k = 0; k < n; ++k) acc[k] += row[k];
+    }
+    for (int y = 0; y < height; ++y) {
+        uchar* out = dst + y * bpl + byteBegin;
+        const uchar* add = src + qMin(y + radius + 1, height - 1) * bpl + byteBegin;
+        const uchar* sub = src + qMax(y - radius, 0) * bpl + byteBegin;
+        int k = 0;
+        for (; k < vectorBytes; k += 16) {
+            __m128i* a = reinterpret_cast<__m128i*>(acc.data() + k);
+            __m128i s0 = _mm_loadu_si128(a);
+            __m128i s1 = _mm_loadu_si128(a + 1);
+            __m128i s2 = _mm_loadu_si128(a + 2);
+            __m128i s3 = _mm_loadu_si128(a + 3);
+
+            __m128i q0 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s0), inv), half));
+            __m128i q1 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s1), inv), half));
+            __m128i q2 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s2), inv), half));
+            __m128i q3 = _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_cvtepi32_ps(s3), inv), half));
+            _mm_storeu_si128(reinterpret_cast<__m128i*>(out + k),
+                             _mm_packus_epi16(_mm_packs_epi32(q0, q1), _mm_packs_epi32(q2, q3)));
+
+            // Difference in 16 bits (-255..255), then sign-extended to 32 bits
+            const __m128i in = _mm_loadu_si128(reinterpret_cast<const __m128i*>(add + k));
+            const __m128i outgoing = _mm_loadu_si128(reinterpret_cast<const __m128i*>(sub + k));
+            const __m128i dLo = _mm_sub_epi16(_mm_unpacklo_epi8(in, zero), _mm_unpacklo_epi8(outgoing, zero));
+            const __m128i dHi = _mm_sub_epi16(_mm_unpackhi_epi8(in, zero), _mm_unpackhi_epi8(outgoing, zero));
+            s0 = _mm_add_epi32(s0, _mm_srai_epi32(_mm_unpacklo_epi16(dLo, dLo), 16));
+            s1 = _mm_add_epi32(s1, _mm_srai_epi32(_mm_unpackhi_epi16(dLo, dLo), 16));
+            s2 = _mm_add_epi32(s2, _mm_srai_epi32(_mm_unpacklo_epi16(dHi, dHi), 16));
+            s3 = _mm_add_epi32(s3, _mm_srai_epi32(_mm_unpackhi_epi16(dHi, dHi), 16));
+            _mm_storeu_si128(a, s0);
+            _mm_storeu_si128(a + 1, s1);
+            _mm_storeu_si128(a + 2, s2);
+            _mm_storeu_si128(a + 3, s3);
+        }
+        for (; k < n; ++k) {
+            out[k] = static_cast<uchar>(acc[k] * invScalar + 0.5f);
+            acc[k] += add[k] - sub[k];
+        }
+    }
+}
+
+// Eight bytes (two pixels) per 256-bit step, widened straight from memory
+BLUR_TARGET_AVX2
+void verticalAvx2(const uchar* src, uchar* dst, int height, qsizetype bpl, int byteBegin, int byteEnd, int radius)
+{
+    const float invScalar = 1.0f / (2 * radius + 1);
+    const __m256 inv = _mm256_set1_ps(invScalar);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const int n = byteEnd - byteBegin;
+    const int vectorBytes = n & ~7;
+    std::vector<quint32> acc(n, 0);
+
+    for (int i = -radius; i <= radius; ++i) {
+        const uchar* row = src + qBound(0, i, height - 1) * bpl + byteBegin;
+        for (int k = 0; k < n; ++k) acc[k] += row[k];
+    }
+    for (int y = 0; y < height; ++y) {
+        uchar* out = dst + y * bpl + byteBegin;
+        const uchar* add = src + qMin(y + radius + 1, height - 1) * bpl + byteBegin;
+        const uchar* sub = src + qMax(y - radius, 0) * bpl + byteBegin;
+        int k = 0;
+        for (; k < vectorBytes; k += 8) {
+            __m256i* a = reinterpret_cast<__m256i*>(acc.data() + k);
+            __m256i sum = _mm256_loadu_si256(a);
+
+            const __m256i q = _mm256_cvttps_epi32(_mm256_add_ps(_mm256_mul_ps(_mm256_cvtepi32_ps(sum), inv), half));
+            const __m128i packed16 = _mm_packs_epi32(_mm256_castsi256_si128(q), _mm256_extracti128_si256(q, 1));
+            _mm_storel_epi64(reinterpret_cast<__m128i*>(out + k), _mm_packus_epi16(packed16, packed16));
+
+            const __m256i in = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(add + k)));
+            const __m256i outgoing = _mm256_cvtepu8_epi32(_mm_loadl_epi64(reinterpret_cast<const __m128i*>(sub + k)));
+            sum = _mm256_add_epi32(sum, _mm256_sub_epi32(in, outgoing));
+            _mm256_storeu_si256(a, sum);
+        }
+        for (; k < n; ++k) {
+            out[k] = static_cast<uchar>(acc[k] * invScalar + 0.5f);
+            acc[k] += add[k] - sub[k];
+        }
+    }
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7) return false;
+    __cpuid(info, 1);
+    const bool osSavesYmm = (info[2] & (1 << 27)) && (_xgetbv(0) & 0x6) == 0x6; // OSXSAVE, then XMM and YMM state
+    __cpuidex(info, 7, 0);
+    return osSavesYmm && (info[1] & (1 << 5));
+#else
+    __builtin_cpu_init();
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // BLUR_HAS_SSE2
+
+struct Kernels
+{
+    HorizontalFn horizontal;
+    VerticalFn vertical;
+};
+
+Kernels kernelsFor(BlurEngine::Path path)
+{
+    switch (path) {
+#if BLUR_HAS_SSE2
+    case BlurEngine::Path::AVX2:
+        return {horizontalSse2, verticalAvx2}; // The horizontal window is serial; wider vectors do not help it
+    case BlurEngine::Path::SSE2:
+        return {horizontalSse2, verticalSse2};
+#endif
+    default:
+        return {horizontalScalar, verticalScalar};
+    }
+}
+
+// Splits [0, count) into one range per pool thread and runs fn over them, or inline when small
+template <typename Fn>
+void forEachBand(int count, int granularity, bool parallel, Fn fn)
+{
+    const int threads = parallel ? qMax(1, QThread::idealThreadCount()) : 1;
+    if (threads == 1 || count <= granularity) {
+        fn(0, count);
+        return;
+    }
+    const int perBand = qMax(granularity, ((count + threads - 1) / threads + granularity - 1) / granularity * granularity);
+    QList<QPair<int, int>> bands;
+    for (int begin = 0; begin < count; begin += perBand) {
+        bands.append(qMakePair(begin, qMin(count, begin + perBand)));
+    }
+    QtConcurrent::blockingMap(bands, [&fn](const QPair<int, int>& band) { fn(band.first, band.second); });
+}
+
+} // namespace
+
+namespace BlurEngine
+{
+
+Path bestPath()
+{
+#if BLUR_HAS_SSE2
+    static const Path path = cpuHasAvx2() ? Path::AVX2 : Path::SSE2;
+    return path;
+#else
+    return Path::Scalar;
+#endif
+}
+
+QString pathName(Path path)
+{
+    switch (path) {
+    case Path::AVX2: return QStringLiteral("AVX2");
+    case Path::SSE2: return QStringLiteral("SSE2");
+    default: return QStringLiteral("Scalar");
+    }
+}
+
+QList<Path> availablePaths()
+{
+    QList<Path> paths{Path::Scalar};
+#if BLUR_HAS_SSE2
+    paths.append(Path::SSE2);
+    if (bestPath() == Path::AVX2) paths.append(Path::AVX2);
+#endif
+    return paths;
+}
+
+int boxRadiusForSigma(qreal sigma, int passes)
+{
+    if (sigma <= 0 || passes <= 0) return 0;
+    // n box passes of width w have variance n * (w^2 - 1) / 12
+    const qreal width = std::sqrt(12.0 * sigma * sigma / passes + 1.0);
+    return qMax(1, qRound((width - 1.0) / 2.0));
+}
+
+void blur(QImage& image, int radiusX, int radiusY, int passes, Path path)
+{
+    if (image.isNull() || passes <= 0 || (radiusX <= 0 && radiusY <= 0)) return;
+    if (image.format() != QImage::Format_ARGB32_Premultiplied) {
+        image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    }
+    const int width = image.width();
+    const int height = image.height();
+    // Windows wider than the image only repeat edge pixels; clamping keeps the sums small
+    radiusX = qMin(radiusX, width);
+    radiusY = qMin(radiusY, height);
+
+    const Kernels kernels = kernelsFor(path);
+    const bool parallel = qint64(width) * height >= PARALLEL_THRESHOLD_PIXELS;
+    QImage scratch(width, height, QImage::Format_ARGB32_Premultiplied);
+    const qsizetype bpl = image.bytesPerLine();
+    Q_ASSERT(scratch.bytesPerLine() == bpl); // Same width and format, so the same stride
+
+    uchar* pixels = image.bits();
+    uchar* temp = scratch.bits();
+    for (int pass = 0; pass < passes; ++pass) {
+        // image -> scratch horizontally, scratch -> image vertically; a radius of 0 is a copy
+        if (radiusX > 0) {
+            forEachBand(height, 8, parallel, [&](int begin, int end) {
+                kernels.horizontal(pixels, temp, width, bpl, begin, end, radiusX);
+            });
+        } else {
+            std::memcpy(temp, pixels, bpl * height);
+        }
+        if (radiusY > 0) {
+            // Bands are whole 16-byte multiples so every band but the last runs fully vectorized
+            forEachBand(width * 4, 64, parallel, [&](int begin, int end) {
+                kernels.vertical(temp, pixels, height, bpl, begin, end, radiusY);
+            });
+        } else {
+            std::memcpy(pixels, temp, bpl * height);
+        }
+    }
+}
+
+void blur(QImage& image, int radiusX, int radiusY, int passes)
+{
+    blur(image, radiusX, radiusY, passes, bestPath());
+}
+
+QImage blurred(const QImage& source, int radiusX, int radiusY, int passes)
+{
+    QImage result = source.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    blur(result, radiusX, radiusY, passes);
+    return result;
+}
+
+QList<BenchmarkResult> benchmark(const QSize& size, const QList<int>& radii, int iterations)
+{
+    QList<BenchmarkResult> results;
+    QImage source(size, QImage::Format_ARGB32_Premultiplied);
+    QRandomGenerator generator(42);
+    for (int y = 0; y < source.height(); ++y) {
+        QRgb* line = reinterpret_cast<QRgb*>(source.scanLine(y));
+        for (int x = 0; x < source.width(); ++x) {
+            line[x] = qPremultiply(generator.generate()); // Noise: no fast paths, no cache-friendly runs
+        }
+    }
+    const double megabytes = double(source.sizeInBytes()) / (1000.0 * 1000.0);
+
+    for (Path path : availablePaths()) {
+        for (int radius : radii) {
+            QImage work = source;
+            blur(work, radius, radius, 3, path); // Warm-up: page in the buffers and start the pool threads
+            QElapsedTimer timer;
+            timer.start();
+            for (int i = 0; i < iterations; ++i) {
+                work = source; // Detaches on the first write, like a real caller
+                blur(work, radius, radius, 3, path);
+            }
+            const double seconds = qMax<qint64>(1, timer.nsecsElapsed()) / 1e9;
+            results.append({path, radius, size, megabytes * iterations / seconds});
+        }
+    }
+    return results;
+}
+
+QString formatBenchmark(const QList<BenchmarkResult>& results)
+{
+    QString text;
+    for (const BenchmarkResult& result : results) {
+        text += QString("%1  radius %2  %3x%4  %5 MB/s\n")
+                    .arg(pathName(result.path), -6)
+                    .arg(result.radius, 3)
+                    .arg(result.size.width())
+                    .arg(result.size.height())
+                    .arg(result.megabytesPerSecond, 8, 'f', 1);
+    }
+    return text;
+}
+
+} // namespace BlurEngine
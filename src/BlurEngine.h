@@ -0,0 +1,42 @@
+#ifndef BLURENGINE_H
+#define BLURENGINE_H
+
+#include <QImage>
+#include <QList>
+#include <QSize>
+#include <QString>
+
+// Separable box blur for ARGB32 premultiplied images. Three box passes approximate a Gaussian.
+// Each pass is a horizontal sliding-window sum per row followed by a vertical one that sweeps
+// a row of column sums down the image, so the cost per pixel does not depend on the radius.
+// Rows (horizontal) and column bands (vertical) are spread over the global thread pool.
+// The kernel is chosen once at runtime: AVX2, SSE2 or scalar. All three give identical output.
+namespace BlurEngine
+{
+    enum class Path { Scalar, SSE2, AVX2 };
+
+    Path bestPath();                    // Fastest kernel this CPU supports
+    QString pathName(Path path);
+    QList<Path> availablePaths();       // Scalar first, then every SIMD path the CPU supports
+
+    // Box radius per pass that approximates a Gaussian of the given sigma over 'passes' passes
+    int boxRadiusForSigma(qreal sigma, int passes = 3);
+
+    // Blurs in place. Other formats are converted to ARGB32_Premultiplied first.
+    void blur(QImage& image, int radiusX, int radiusY, int passes = 3);
+    void blur(QImage& image, int radiusX, int radiusY, int passes, Path path); // Forced kernel
+    QImage blurred(const QImage& source, int radiusX, int radiusY, int passes = 3);
+
+    struct BenchmarkResult
+    {
+        Path path;
+        int radius;
+        QSize size;
+        double megabytesPerSecond; // Source image bytes blurred per second, all passes included
+    };
+    QList<BenchmarkResult> benchmark(const QSize& size = QSize(3840, 2160),
+                                     const QList<int>& radii = {2, 8, 24}, int iterations = 5);
+    QString formatBenchmark(const QList<BenchmarkResult>& results); // One line per result
+}
+
+#endif // BLURENGINE_H
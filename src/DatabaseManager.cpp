@@ -3,12 +3,16 @@
 #include "PageData.h"
 #include "ZoneData.h"
 #include "IconData.h"
+#include "IconStackData.h"
 
 #include <QtSql/QSqlQuery>
 #include <QtSql/QSqlError>
 #include <QStandardPaths>
 #include <QDir>
 #include <QDebug>
+#include "Logging.h"
+#include "PerfMonitor.h" // For save timings on the performance HUD
+#include <QHash>
 #include <QUuid> // For string to QUuid conversion and vice-versa
 
 DatabaseManager::DatabaseManager(const QString& dbName, QObject *parent)
@@ -55,6 +59,11 @@ bool DatabaseManager::openDatabase()
         return false;
     }
     qDebug() << "Database opened successfully:" << m_dbPath;
+    // SQLite leaves foreign keys off per connection; ON DELETE CASCADE in the schema needs them.
+    QSqlQuery pragmaQuery(m_database);
+    if (!pragmaQuery.exec("PRAGMA foreign_keys = ON")) {
+        qWarning() << "Failed to enable foreign keys:" << pragmaQuery.lastError().text();
+    }
     return createTablesIfNotExist();
 }
 
@@ -114,11 +123,38 @@ bool DatabaseManager::createTablesIfNotExist()
                     "file_path TEXT NOT NULL,"
                     "pos_x_in_zone REAL NOT NULL,"
                     "pos_y_in_zone REAL NOT NULL,"
+                    "stack_id TEXT," // NULL for loose icons
                     "FOREIGN KEY(zone_id) REFERENCES Zones(zone_id) ON DELETE CASCADE"
                     ");")) {
         qWarning() << "Failed to create Icons table:" << query.lastError().text();
         success = false;
     }
+    // Databases created before icon stacks existed lack the column
+    if (success && !ensureColumnExists("Icons", "stack_id", "TEXT")) {
+        success = false;
+    }
+
+    // IconStacks Table
+    if (!query.exec("CREATE TABLE IF NOT EXISTS IconStacks ("
+                    "stack_id TEXT PRIMARY KEY NOT NULL,"
+                    "zone_id TEXT NOT NULL,"
+                    "stack_title TEXT,"
+                    "pos_x_in_zone REAL NOT NULL,"
+                    "pos_y_in_zone REAL NOT NULL,"
+                    "FOREIGN KEY(zone_id) REFERENCES Zones(zone_id) ON DELETE CASCADE"
+                    ");")) {
+        qWarning() << "Failed to create IconStacks table:" << query.lastError().text();
+        success = false;
+    }
+
+    // PageThumbnails Table
+    if (!query.exec("CREATE TABLE IF NOT EXISTS PageThumbnails ("
+                    "page_id TEXT PRIMARY KEY NOT NULL,"
+                    "image BLOB NOT NULL" // PNG
+                    ");")) {
+        qWarning() << "Failed to create PageThumbnails table:" << query.lastError().text();
+        success = false;
+    }
 
     if (success) {
         qDebug() << "Database tables checked/created successfully.";
@@ -126,15 +162,38 @@ bool DatabaseManager::createTablesIfNotExist()
     return success;
 }
 
+bool DatabaseManager::ensureColumnExists(const QString& table, const QString& column, const QString& type)
+{
+    QSqlQuery infoQuery(m_database);
+    if (!infoQuery.exec(QString("PRAGMA table_info(%1)").arg(table))) {
+        qWarning() << "Failed to read columns of" << table << ":" << infoQuery.lastError().text();
+        return false;
+    }
+    while (infoQuery.next()) {
+        if (infoQuery.value("name").toString() == column) {
+            return true;
+        }
+    }
+
+    QSqlQuery alterQuery(m_database);
+    if (!alterQuery.exec(QString("ALTER TABLE %1 ADD COLUMN %2 %3").arg(table, column, type))) {
+        qWarning() << "Failed to add column" << column << "to" << table << ":" << alterQuery.lastError().text();
+        return false;
+    }
+    qCDebug(lcDatabase) << "Migrated table" << table << ": added column" << column;
+    return true;
+}
+
 
 // --- Saving Logic ---
-bool DatabaseManager::savePages(const QList<PageData*>& pages)
+bool DatabaseManager::savePages(const LayoutSnapshot& layout)
 {
     if (!m_database.isOpen()) {
         qWarning() << "Database not open, cannot save pages.";
         return false;
     }
 
+    PerfMonitor::SaveScope saveTiming("full");
     m_database.transaction(); // Start transaction for batch saving
 
     // Clear existing data first to handle deletions and reordering correctly
@@ -143,40 +202,62 @@ bool DatabaseManager::savePages(const QList<PageData*>& pages)
     if (!clearQuery.exec("DELETE FROM Pages")) {
         qWarning() << "Failed to clear Pages table:" << clearQuery.lastError().text();
         m_database.rollback();
+        saveTiming.ok = false;
         return false;
     }
     // No need to explicitly delete from Zones and Icons due to ON DELETE CASCADE.
 
     bool all_success = true;
-    for (int i = 0; i < pages.count(); ++i) {
-        PageData* page = pages.at(i);
-        if (!page) continue;
+    for (int i = 0; i < layout.pages.count(); ++i) {
+        const PageSnapshot& page = layout.pages.at(i);
+        if (page.isNull()) continue;
 
         if (!savePage(page, i)) { // Save page with its order
             all_success = false;
             break;
         }
-        for (ZoneData* zone : page->zones()) {
-            if (!zone) continue;
-            if (!saveZone(zone, page->id())) {
+        for (const ZoneSnapshot& zone : page.zones()) {
+            if (zone.isNull()) continue;
+            if (!saveZone(zone, page.id())) {
                 all_success = false;
                 break;
             }
-            for (IconData* icon : zone->icons()) {
-                if (!icon) continue;
-                if (!saveIcon(icon, zone->id())) {
+            for (const IconSnapshot& icon : zone.icons()) {
+                if (!saveIcon(icon, zone.id())) {
+                    all_success = false;
+                    break;
+                }
+            }
+            if (!all_success) break;
+            for (const IconStackSnapshot& stack : zone.stacks()) {
+                if (!saveStack(stack, zone.id())) {
                     all_success = false;
                     break;
                 }
+                for (const IconSnapshot& icon : stack.icons) {
+                    if (!saveIcon(icon, zone.id(), stack.id)) {
+                        all_success = false;
+                        break;
+                    }
+                }
+                if (!all_success) break;
             }
             if (!all_success) break;
         }
         if (!all_success) break;
     }
 
+    if (all_success) {
+        QSqlQuery pruneQuery(m_database);
+        if (!pruneQuery.exec("DELETE FROM PageThumbnails WHERE page_id NOT IN (SELECT page_id FROM Pages)")) {
+            qWarning() << "Failed to prune page thumbnails:" << pruneQuery.lastError().text(); // Harmless leftovers
+        }
+    }
+
+    saveTiming.ok = all_success;
     if (all_success) {
         m_database.commit();
-        qDebug() << "All pages and their contents saved successfully.";
+        qCDebug(lcDatabase) << "Layout version" << layout.version << "saved successfully.";
         return true;
     } else {
         qWarning() << "Failed to save one or more items. Rolling back transaction.";
@@ -185,70 +266,308 @@ bool DatabaseManager::savePages(const QList<PageData*>& pages)
     }
 }
 
-bool DatabaseManager::savePage(PageData* pageData, int order)
+bool DatabaseManager::savePage(const PageSnapshot& page, int order)
 {
     QSqlQuery query(m_database);
     query.prepare("INSERT INTO Pages (page_id, page_name, page_order, wallpaper_path, overlay_color) "
                   "VALUES (:page_id, :page_name, :page_order, :wallpaper_path, :overlay_color)");
-    query.bindValue(":page_id", pageData->id().toString());
-    query.bindValue(":page_name", pageData->name());
+    query.bindValue(":page_id", page.id().toString());
+    query.bindValue(":page_name", page.name());
     query.bindValue(":page_order", order);
-    query.bindValue(":wallpaper_path", pageData->wallpaperPath().isEmpty() ? QVariant(QVariant::String) : pageData->wallpaperPath());
-    query.bindValue(":overlay_color", pageData->overlayColor().isValid() ? pageData->overlayColor().name(QColor::HexArgb) : QVariant(QVariant::String));
+    query.bindValue(":wallpaper_path", page.wallpaperPath().isEmpty() ? QVariant(QVariant::String) : page.wallpaperPath());
+    query.bindValue(":overlay_color", page.overlayColor().isValid() ? page.overlayColor().name(QColor::HexArgb) : QVariant(QVariant::String));
 
 
     if (!query.exec()) {
-        qWarning() << "Failed to save page" << pageData->id() << ":" << query.lastError().text();
+        qWarning() << "Failed to save page" << page.id() << ":" << query.lastError().text();
         return false;
     }
     return true;
 }
 
-bool DatabaseManager::saveZone(ZoneData* zoneData, const QUuid& pageId)
+bool DatabaseManager::saveZone(const ZoneSnapshot& zone, const QUuid& pageId)
 {
     QSqlQuery query(m_database);
     query.prepare("INSERT INTO Zones (zone_id, page_id, zone_title, pos_x, pos_y, width, height, bg_color, corner_radius, background_image_path, blur_background_image) "
                   "VALUES (:zone_id, :page_id, :zone_title, :pos_x, :pos_y, :width, :height, :bg_color, :corner_radius, :bg_image_path, :blur_bg_image)");
-    query.bindValue(":zone_id", zoneData->id().toString());
+    query.bindValue(":zone_id", zone.id().toString());
     query.bindValue(":page_id", pageId.toString());
-    query.bindValue(":zone_title", zoneData->title());
-    query.bindValue(":pos_x", zoneData->geometry().x());
-    query.bindValue(":pos_y", zoneData->geometry().y());
-    query.bindValue(":width", zoneData->geometry().width());
-    query.bindValue(":height", zoneData->geometry().height());
-    query.bindValue(":bg_color", zoneData->backgroundColor().name(QColor::HexArgb));
-    query.bindValue(":corner_radius", zoneData->cornerRadius());
-    query.bindValue(":bg_image_path", zoneData->backgroundImagePath().isEmpty() ? QVariant(QVariant::String) : zoneData->backgroundImagePath()); // Store NULL if empty
-    query.bindValue(":blur_bg_image", zoneData->blurBackgroundImage() ? 1 : 0);
+    query.bindValue(":zone_title", zone.title());
+    query.bindValue(":pos_x", zone.geometry().x());
+    query.bindValue(":pos_y", zone.geometry().y());
+    query.bindValue(":width", zone.geometry().width());
+    query.bindValue(":height", zone.geometry().height());
+    query.bindValue(":bg_color", zone.backgroundColor().name(QColor::HexArgb));
+    query.bindValue(":corner_radius", zone.cornerRadius());
+    query.bindValue(":bg_image_path", zone.backgroundImagePath().isEmpty() ? QVariant(QVariant::String) : zone.backgroundImagePath()); // Store NULL if empty
+    query.bindValue(":blur_bg_image", zone.blurBackgroundImage() ? 1 : 0);
 
 
     if (!query.exec()) {
-        qWarning() << "Failed to save zone" << zoneData->id() << ":" << query.lastError().text();
+        qWarning() << "Failed to save zone" << zone.id() << ":" << query.lastError().text();
         return false;
     }
     return true;
 }
 
-bool DatabaseManager::saveIcon(IconData* iconData, const QUuid& zoneId)
+bool DatabaseManager::saveIcon(const IconSnapshot& icon, const QUuid& zoneId, const QUuid& stackId)
 {
     QSqlQuery query(m_database);
-    query.prepare("INSERT INTO Icons (icon_id, zone_id, file_path, pos_x_in_zone, pos_y_in_zone) "
-                  "VALUES (:icon_id, :zone_id, :file_path, :pos_x_in_zone, :pos_y_in_zone)");
-    query.bindValue(":icon_id", iconData->id().toString());
+    query.prepare("INSERT INTO Icons (icon_id, zone_id, file_path, pos_x_in_zone, pos_y_in_zone, stack_id) "
+                  "VALUES (:icon_id, :zone_id, :file_path, :pos_x_in_zone, :pos_y_in_zone, :stack_id)");
+    query.bindValue(":icon_id", icon.id.toString());
     query.bindValue(":zone_id", zoneId.toString());
-    query.bindValue(":file_path", iconData->filePath());
-    query.bindValue(":pos_x_in_zone", iconData->positionInZone().x());
-    query.bindValue(":pos_y_in_zone", iconData->positionInZone().y());
+    query.bindValue(":file_path", icon.filePath);
+    query.bindValue(":pos_x_in_zone", icon.positionInZone.x());
+    query.bindValue(":pos_y_in_zone", icon.positionInZone.y());
+    query.bindValue(":stack_id", stackId.isNull() ? QVariant(QVariant::String) : stackId.toString()); // NULL for loose icons
 
     if (!query.exec()) {
-        qWarning() << "Failed to save icon" << iconData->id() << ":" << query.lastError().text();
+        qWarning() << "Failed to save icon" << icon.id << ":" << query.lastError().text();
         return false;
     }
     return true;
 }
 
+bool DatabaseManager::saveStack(const IconStackSnapshot& stack, const QUuid& zoneId)
+{
+    QSqlQuery query(m_database);
+    query.prepare("INSERT INTO IconStacks (stack_id, zone_id, stack_title, pos_x_in_zone, pos_y_in_zone) "
+                  "VALUES (:stack_id, :zone_id, :stack_title, :pos_x_in_zone, :pos_y_in_zone)");
+    query.bindValue(":stack_id", stack.id.toString());
+    query.bindValue(":zone_id", zoneId.toString());
+    query.bindValue(":stack_title", stack.title);
+    query.bindValue(":pos_x_in_zone", stack.positionInZone.x());
+    query.bindValue(":pos_y_in_zone", stack.positionInZone.y());
+
+    if (!query.exec()) {
+        qWarning() << "Failed to save icon stack" << stack.id << ":" << query.lastError().text();
+        return false;
+    }
+    return true;
+}
+
+
+// --- Incremental Saving ---
+bool DatabaseManager::saveChanges(const QList<ZoneChangeSet>& changes)
+{
+    if (changes.isEmpty()) {
+        return true;
+    }
+    if (!m_database.isOpen() && !openDatabase()) {
+        qWarning() << "Database not open, cannot save changes.";
+        return false;
+    }
+
+    PerfMonitor::SaveScope saveTiming("incremental");
+    m_database.transaction();
+
+    // Prepared once per batch and rebound for every row
+    QSqlQuery zoneExistsQuery(m_database);
+    zoneExistsQuery.prepare("SELECT 1 FROM Zones WHERE zone_id = :zone_id");
+    QSqlQuery zoneUpdateQuery(m_database);
+    zoneUpdateQuery.prepare("UPDATE Zones SET zone_title = :zone_title, pos_x = :pos_x, pos_y = :pos_y, width = :width, height = :height, "
+                            "bg_color = :bg_color, corner_radius = :corner_radius, background_image_path = :bg_image_path, "
+                            "blur_background_image = :blur_bg_image WHERE zone_id = :zone_id");
+    QSqlQuery iconUpsertQuery(m_database);
+    // Also rewrites stack_id, so an icon leaving a stack is saved as loose again
+    iconUpsertQuery.prepare("INSERT OR REPLACE INTO Icons (icon_id, zone_id, file_path, pos_x_in_zone, pos_y_in_zone, stack_id) "
+                            "VALUES (:icon_id, :zone_id, :file_path, :pos_x_in_zone, :pos_y_in_zone, :stack_id)");
+    QSqlQuery iconMoveQuery(m_database);
+    iconMoveQuery.prepare("UPDATE Icons SET pos_x_in_zone = :pos_x_in_zone, pos_y_in_zone = :pos_y_in_zone "
+                          "WHERE icon_id = :icon_id AND zone_id = :zone_id");
+    QSqlQuery iconDeleteQuery(m_database);
+    // Keyed on zone too, so moving an icon to another zone in the same batch cannot delete its new row
+    iconDeleteQuery.prepare("DELETE FROM Icons WHERE icon_id = :icon_id AND zone_id = :zone_id");
+    QSqlQuery stackClearQuery(m_database);
+    stackClearQuery.prepare("DELETE FROM IconStacks WHERE zone_id = :zone_id");
+    QSqlQuery stackInsertQuery(m_database);
+    stackInsertQuery.prepare("INSERT INTO IconStacks (stack_id, zone_id, stack_title, pos_x_in_zone, pos_y_in_zone) "
+                             "VALUES (:stack_id, :zone_id, :stack_title, :pos_x_in_zone, :pos_y_in_zone)");
+
+    bool all_success = true;
+    for (const ZoneChangeSet& changeSet : changes) {
+        ZoneData* zone = changeSet.zone;
+        if (!zone) continue;
+        const QString zoneId = zone->id().toString();
+
+        zoneExistsQuery.bindValue(":zone_id", zoneId);
+        if (!zoneExistsQuery.exec()) {
+            qWarning() << "Failed to look up zone" << zone->id() << ":" << zoneExistsQuery.lastError().text();
+            all_success = false;
+            break;
+        }
+        bool zoneExists = zoneExistsQuery.next();
+        zoneExistsQuery.finish();
+        if (!zoneExists) {
+            qCDebug(lcDatabase) << "Zone" << zone->id() << "not saved yet, deferring its changes to the next full save.";
+            continue;
+        }
+
+        if (changeSet.changes != ZoneChangeSet::NoChange) {
+            zoneUpdateQuery.bindValue(":zone_id", zoneId);
+            zoneUpdateQuery.bindValue(":zone_title", zone->title());
+            zoneUpdateQuery.bindValue(":pos_x", zone->geometry().x());
+            zoneUpdateQuery.bindValue(":pos_y", zone->geometry().y());
+            zoneUpdateQuery.bindValue(":width", zone->geometry().width());
+            zoneUpdateQuery.bindValue(":height", zone->geometry().height());
+            zoneUpdateQuery.bindValue(":bg_color", zone->backgroundColor().name(QColor::HexArgb));
+            zoneUpdateQuery.bindValue(":corner_radius", zone->cornerRadius());
+            zoneUpdateQuery.bindValue(":bg_image_path", zone->backgroundImagePath().isEmpty() ? QVariant(QVariant::String) : zone->backgroundImagePath());
+            zoneUpdateQuery.bindValue(":blur_bg_image", zone->blurBackgroundImage() ? 1 : 0);
+            if (!zoneUpdateQuery.exec()) {
+                qWarning() << "Failed to update zone" << zone->id() << ":" << zoneUpdateQuery.lastError().text();
+                all_success = false;
+                break;
+            }
+        }
+
+        for (const QUuid& iconId : changeSet.removedIconIds) {
+            iconDeleteQuery.bindValue(":icon_id", iconId.toString());
+            iconDeleteQuery.bindValue(":zone_id", zoneId);
+            if (!iconDeleteQuery.exec()) {
+                qWarning() << "Failed to delete icon" << iconId << ":" << iconDeleteQuery.lastError().text();
+                all_success = false;
+                break;
+            }
+        }
+        if (!all_success) break;
+
+        // Icons transferred in from another zone are rewritten like additions: the upsert moves the row here
+        QList<QUuid> upsertIds = changeSet.addedIconIds;
+        for (const ZoneChangeSet::Transfer& transfer : changeSet.transfersIn) {
+            upsertIds.append(transfer.iconId);
+        }
+        for (const QUuid& iconId : std::as_const(upsertIds)) {
+            IconData* icon = zone->findIcon(iconId);
+            if (!icon) continue;
+            iconUpsertQuery.bindValue(":icon_id", iconId.toString());
+            iconUpsertQuery.bindValue(":zone_id", zoneId);
+            iconUpsertQuery.bindValue(":file_path", icon->filePath());
+            iconUpsertQuery.bindValue(":pos_x_in_zone", icon->positionInZone().x());
+            iconUpsertQuery.bindValue(":pos_y_in_zone", icon->positionInZone().y());
+            iconUpsertQuery.bindValue(":stack_id", QVariant(QVariant::String));
+            if (!iconUpsertQuery.exec()) {
+                qWarning() << "Failed to save icon" << iconId << ":" << iconUpsertQuery.lastError().text();
+                all_success = false;
+                break;
+            }
+        }
+        if (!all_success) break;
+
+        for (const QUuid& iconId : changeSet.movedIconIds) {
+            IconData* icon = zone->findIcon(iconId);
+            if (!icon) continue;
+            iconMoveQuery.bindValue(":icon_id", iconId.toString());
+            iconMoveQuery.bindValue(":zone_id", zoneId);
+            iconMoveQuery.bindValue(":pos_x_in_zone", icon->positionInZone().x());
+            iconMoveQuery.bindValue(":pos_y_in_zone", icon->positionInZone().y());
+            if (!iconMoveQuery.exec()) {
+                qWarning() << "Failed to update icon position" << iconId << ":" << iconMoveQuery.lastError().text();
+                all_success = false;
+                break;
+            }
+        }
+        if (!all_success) break;
+
+        if (changeSet.changes.testFlag(ZoneChangeSet::StacksChange)) {
+            // Stacks are few per zone, so rewrite them all together with their members' rows
+            stackClearQuery.bindValue(":zone_id", zoneId);
+            if (!stackClearQuery.exec()) {
+                qWarning() << "Failed to clear stacks of zone" << zone->id() << ":" << stackClearQuery.lastError().text();
+                all_success = false;
+                break;
+            }
+            for (IconStackData* stack : zone->stacks()) {
+                stackInsertQuery.bindValue(":stack_id", stack->id().toString());
+                stackInsertQuery.bindValue(":zone_id", zoneId);
+                stackInsertQuery.bindValue(":stack_title", stack->title());
+                stackInsertQuery.bindValue(":pos_x_in_zone", stack->positionInZone().x());
+                stackInsertQuery.bindValue(":pos_y_in_zone", stack->positionInZone().y());
+                if (!stackInsertQuery.exec()) {
+                    qWarning() << "Failed to save icon stack" << stack->id() << ":" << stackInsertQuery.lastError().text();
+                    all_success = false;
+                    break;
+                }
+                for (IconData* icon : stack->icons()) {
+                    iconUpsertQuery.bindValue(":icon_id", icon->id().toString());
+                    iconUpsertQuery.bindValue(":zone_id", zoneId);
+                    iconUpsertQuery.bindValue(":file_path", icon->filePath());
+                    iconUpsertQuery.bindValue(":pos_x_in_zone", icon->positionInZone().x());
+                    iconUpsertQuery.bindValue(":pos_y_in_zone", icon->positionInZone().y());
+                    iconUpsertQuery.bindValue(":stack_id", stack->id().toString());
+                    if (!iconUpsertQuery.exec()) {
+                        qWarning() << "Failed to save stacked icon" << icon->id() << ":" << iconUpsertQuery.lastError().text();
+                        all_success = false;
+                        break;
+                    }
+                }
+                if (!all_success) break;
+            }
+            if (!all_success) break;
+        }
+    }
+
+    saveTiming.ok = all_success;
+    if (all_success) {
+        m_database.commit();
+        qCDebug(lcDatabase) << "Saved change batch for" << changes.count() << "zone(s).";
+        return true;
+    } else {
+        qWarning() << "Failed to save change batch. Rolling back transaction.";
+        m_database.rollback();
+        return false;
+    }
+}
+
+bool DatabaseManager::saveThumbnails(const QHash<QUuid, QByteArray>& pngByPageId)
+{
+    if (pngByPageId.isEmpty()) {
+        return true;
+    }
+    if (!m_database.isOpen() && !openDatabase()) {
+        qWarning() << "Database not open, cannot save page thumbnails.";
+        return false;
+    }
+
+    m_database.transaction();
+    QSqlQuery query(m_database);
+    query.prepare("INSERT OR REPLACE INTO PageThumbnails (page_id, image) VALUES (:page_id, :image)");
+    for (auto it = pngByPageId.constBegin(); it != pngByPageId.constEnd(); ++it) {
+        query.bindValue(":page_id", it.key().toString());
+        query.bindValue(":image", it.value());
+        if (!query.exec()) {
+            qWarning() << "Failed to save thumbnail of page" << it.key() << ":" << query.lastError().text();
+            m_database.rollback();
+            return false;
+        }
+    }
+    m_database.commit();
+    qCDebug(lcDatabase) << "Saved" << pngByPageId.size() << "page thumbnails";
+    return true;
+}
+
 
 // --- Loading Logic ---
+QHash<QUuid, QByteArray> DatabaseManager::loadThumbnails()
+{
+    QHash<QUuid, QByteArray> pngByPageId;
+    if (!m_database.isOpen()) {
+        qWarning() << "Database not open, cannot load page thumbnails.";
+        return pngByPageId;
+    }
+    QSqlQuery query("SELECT page_id, image FROM PageThumbnails", m_database);
+    if (!query.exec()) {
+        qWarning() << "Failed to load page thumbnails:" << query.lastError().text();
+        return pngByPageId;
+    }
+    while (query.next()) {
+        pngByPageId.insert(QUuid(query.value("page_id").toString()), query.value("image").toByteArray());
+    }
+    qCDebug(lcDatabase) << "Loaded" << pngByPageId.size() << "page thumbnails";
+    return pngByPageId;
+}
+
 bool DatabaseManager::loadPages(PageManager* pageManager)
 {
     if (!m_database.isOpen() || !pageManager) {
@@ -256,6 +575,7 @@ bool DatabaseManager::loadPages(PageManager* pageManager)
         return false;
     }
 
+    PageManager::BatchScope batch(pageManager); // Publish one layout snapshot for the whole load
     pageManager->clearAllPages(); // Clear any existing in-memory pages before loading
 
     QSqlQuery pageQuery("SELECT page_id, page_name, wallpaper_path, overlay_color FROM Pages ORDER BY page_order ASC", m_database);
@@ -264,7 +584,7 @@ bool DatabaseManager::loadPages(PageManager* pageManager)
         return false;
     }
 
-    qDebug() << "Loading pages from database...";
+    qCDebug(lcDatabase) << "Loading pages from database...";
     while (pageQuery.next()) {
         QUuid pageId = QUuid(pageQuery.value("page_id").toString());
         QString pageName = pageQuery.value("page_name").toString();
@@ -300,9 +620,27 @@ bool DatabaseManager::loadPages(PageManager* pageManager)
 
             ZoneData* newZoneData = new ZoneData(zoneId, zoneTitle, zoneGeo, zoneColor, cornerRadius, bgImagePath, blurBgImage);
 
+            // Load icon stacks first so their members can be placed into them
+            QHash<QString, IconStackData*> stacksById;
+            QSqlQuery stackQuery(m_database);
+            stackQuery.prepare("SELECT stack_id, stack_title, pos_x_in_zone, pos_y_in_zone "
+                               "FROM IconStacks WHERE zone_id = :zone_id");
+            stackQuery.bindValue(":zone_id", zoneId.toString());
+            if (!stackQuery.exec()) {
+                qWarning() << "Failed to load icon stacks for zone" << zoneId << ":" << stackQuery.lastError().text();
+            }
+            while (stackQuery.next()) {
+                QString stackId = stackQuery.value("stack_id").toString();
+                IconStackData* newStackData = new IconStackData(QUuid(stackId), stackQuery.value("stack_title").toString(),
+                                                                QPointF(stackQuery.value("pos_x_in_zone").toReal(),
+                                                                        stackQuery.value("pos_y_in_zone").toReal()));
+                stacksById.insert(stackId, newStackData);
+                newZoneData->addStack(newStackData); // ZoneData takes ownership
+            }
+
             // Load Icons for this zone
             QSqlQuery iconQuery(m_database);
-            iconQuery.prepare("SELECT icon_id, file_path, pos_x_in_zone, pos_y_in_zone "
+            iconQuery.prepare("SELECT icon_id, file_path, pos_x_in_zone, pos_y_in_zone, stack_id "
                               "FROM Icons WHERE zone_id = :zone_id");
             iconQuery.bindValue(":zone_id", zoneId.toString());
             if (!iconQuery.exec()) {
@@ -316,14 +654,19 @@ bool DatabaseManager::loadPages(PageManager* pageManager)
                 QPointF iconPos(iconQuery.value("pos_x_in_zone").toReal(),
                                 iconQuery.value("pos_y_in_zone").toReal());
                 IconData* newIconData = new IconData(iconId, filePath, iconPos);
-                newZoneData->addIcon(newIconData); // ZoneData takes ownership
+                IconStackData* stack = stacksById.value(iconQuery.value("stack_id").toString(), nullptr);
+                if (stack) {
+                    stack->addIcon(newIconData); // The stack takes ownership
+                } else {
+                    newZoneData->addIcon(newIconData); // ZoneData takes ownership
+                }
             }
             newPageData->addZone(newZoneData); // PageData takes ownership
         }
         pageManager->addLoadedPage(newPageData); // PageManager needs this method
     }
 
-    qDebug() << "Finished loading pages from database. Total pages loaded:" << pageManager->pageCount();
+    qCDebug(lcDatabase) << "Finished loading pages from database. Total pages loaded:" << pageManager->pageCount();
     if (pageManager->pageCount() > 0 && pageManager->activePageIndex() == -1) {
         pageManager->setActivePageIndex(0); // Activate first page if any loaded
     }
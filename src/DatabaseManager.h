@@ -5,10 +5,16 @@
 #include <QString>
 #include <QtSql/QSqlDatabase>
 #include <QList>
+#include <QHash>
+#include <QByteArray>
+#include <QUuid>
+#include "ZoneChangeSet.h"
+#include "LayoutSnapshot.h"
 
 class PageData;   // Forward declaration
 class ZoneData;   // Forward declaration
 class IconData;   // Forward declaration
+class IconStackData; // Forward declaration
 class PageManager; // Forward declaration
 
 class DatabaseManager : public QObject
@@ -22,17 +28,32 @@ public:
     void closeDatabase();
 
     bool loadPages(PageManager* pageManager); // Populates PageManager from DB
-    bool savePages(const QList<PageData*>& pages); // Saves all pages and their contents
+    // Saves all pages and their contents as one published layout version. Reads nothing from
+    // the live model, so it does not care which thread it runs on or what the GUI edits meanwhile.
+    bool savePages(const LayoutSnapshot& layout);
+
+    // Page overview thumbnails as PNG data. Not tied to Pages by a foreign key, so the full
+    // save's delete-and-reinsert keeps them; savePages() drops those of removed pages instead.
+    QHash<QUuid, QByteArray> loadThumbnails();
+    bool saveThumbnails(const QHash<QUuid, QByteArray>& pngByPageId); // Inserts or replaces, one transaction
 
     QString databasePath() const { return m_dbPath; }
 
+public slots:
+    // Writes one committed PageManager batch in a single transaction: zone row updates,
+    // icon inserts, position updates and deletes. Zones not yet in the database are skipped;
+    // the full savePages() on close writes them.
+    bool saveChanges(const QList<ZoneChangeSet>& changes);
+
 private:
     bool createTablesIfNotExist();
+    bool ensureColumnExists(const QString& table, const QString& column, const QString& type); // Adds it if missing
 
     // Helper save methods
-    bool savePage(PageData* pageData, int order);
-    bool saveZone(ZoneData* zoneData, const QUuid& pageId);
-    bool saveIcon(IconData* iconData, const QUuid& zoneId);
+    bool savePage(const PageSnapshot& page, int order);
+    bool saveZone(const ZoneSnapshot& zone, const QUuid& pageId);
+    bool saveIcon(const IconSnapshot& icon, const QUuid& zoneId, const QUuid& stackId = QUuid()); // Null stackId for loose icons
+    bool saveStack(const IconStackSnapshot& stack, const QUuid& zoneId);
 
     // Helper load methods
     // Load methods will directly populate PageData, ZoneData, IconData objects
@@ -0,0 +1,29 @@
+#include "DragGhost.h"
+#include <QPainter>
+
+DragGhost::DragGhost(const QPixmap& snapshot, QWidget* anchor)
+    : QWidget(anchor ? anchor->window() : nullptr,
+              Qt::ToolTip | Qt::FramelessWindowHint | Qt::WindowTransparentForInput | Qt::NoDropShadowWindowHint),
+      m_snapshot(snapshot)
+{
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_TransparentForMouseEvents); // The drop target is found under it
+    setAttribute(Qt::WA_ShowWithoutActivating);     // Focus stays with the widget being dragged
+    resize(m_snapshot.deviceIndependentSize().toSize());
+}
+
+void DragGhost::moveTo(const QPoint& globalTopLeft)
+{
+    move(globalTopLeft);
+    if (!isVisible()) {
+        show();
+    }
+}
+
+void DragGhost::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setOpacity(0.8); // Lets the drop position show through
+    painter.drawPixmap(0, 0, m_snapshot); // Only on show; moving the window does not repaint it
+}
@@ -0,0 +1,27 @@
+#ifndef DRAGGHOST_H
+#define DRAGGHOST_H
+
+#include <QWidget>
+#include <QPixmap>
+
+// Snapshot of whatever is being dragged, shown under the cursor in a frameless window of its own.
+// The window system moves it, so a drag step repaints nothing in the page: the zone or icon being
+// dragged stays where it is and is moved once, on release. Mouse events pass through it.
+class DragGhost : public QWidget
+{
+    Q_OBJECT
+
+public:
+    // snapshot is shown at its device-independent size. anchor only ties the window to its top-level.
+    DragGhost(const QPixmap& snapshot, QWidget* anchor);
+
+    void moveTo(const QPoint& globalTopLeft); // Shows the ghost on the first call
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+
+private:
+    QPixmap m_snapshot;
+};
+
+#endif // DRAGGHOST_H
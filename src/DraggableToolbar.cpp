@@ -9,16 +9,18 @@
 DraggableToolbar::DraggableToolbar(Orientation orientation, QWidget *parent)
     : WidgetHostWindow(parent), m_orientation(orientation)
 {
+    // The fixed size is the body's; the window adds the shadow margins around it
+    const QMargins shadow = shadowMargins();
     if (m_orientation == Orientation::Horizontal) {
         m_toolbarLayout = new QHBoxLayout(this);
-        setFixedHeight(50); // Example fixed height for horizontal toolbar
+        setFixedHeight(50 + shadow.top() + shadow.bottom()); // Example fixed height for horizontal toolbar
         // Width will be based on content or initial set
     } else {
         m_toolbarLayout = new QVBoxLayout(this);
-        setFixedWidth(50); // Example fixed width for vertical toolbar
+        setFixedWidth(50 + shadow.left() + shadow.right()); // Example fixed width for vertical toolbar
         // Height will be based on content
     }
-    m_toolbarLayout->setContentsMargins(2, 2, 2, 2);
+    m_toolbarLayout->setContentsMargins(2, 2, 2, 2); // Inside the body
     m_toolbarLayout->setSpacing(2);
     setLayout(m_toolbarLayout);
 
@@ -93,7 +95,8 @@ void DraggableToolbar::snapToScreenEdge()
     if (!screen) return;
 
     QRect screenGeometry = screen->availableGeometry(); // Use available to avoid OS taskbars etc.
-    QRect windowGeometry = frameGeometry(); // Current window geometry
+    const QMargins shadow = shadowMargins();
+    QRect windowGeometry = frameGeometry().marginsRemoved(shadow); // The body snaps; the shadow may run off screen
 
     int newX = windowGeometry.x();
     int newY = windowGeometry.y();
@@ -123,7 +126,7 @@ void DraggableToolbar::snapToScreenEdge()
 
     if (moved) {
         qDebug() << "Snapping toolbar from" << windowGeometry.topLeft() << "to" << QPoint(newX, newY);
-        move(newX, newY);
+        move(newX - shadow.left(), newY - shadow.top());
         // TODO: Persist new position (this will be handled by MainWindow or a dedicated manager)
         // For example, emit a signal: emit geometryChanged(this->geometry());
     }
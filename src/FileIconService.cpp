@@ -0,0 +1,115 @@
+#include "FileIconService.h"
+#include <QCoreApplication>
+#include <QFileIconProvider>
+#include <QFileInfo>
+#include <QMimeDatabase>
+#include <QDebug>
+#include "Logging.h"
+
+namespace {
+
+// Files whose icon is embedded in or chosen by the file itself, not by its type
+bool hasOwnIcon(const QFileInfo& info)
+{
+    if (info.isBundle()) return true;
+    if (info.isFile() && info.isExecutable()) return true;
+    static const QSet<QString> ownIconSuffixes = {"exe", "lnk", "url", "desktop", "ico", "appimage"};
+    return ownIconSuffixes.contains(info.suffix().toLower());
+}
+
+}
+
+FileIconService::FileIconService(QObject* parent)
+    : QObject(parent), m_iconKeyByPath(4096), m_iconsByKey(512), m_pixmaps(32 * 1024)
+{
+    m_pool.setMaxThreadCount(2); // Icon lookups are I/O bound; a hung mount must not take every core
+}
+
+FileIconService* FileIconService::instance()
+{
+    static FileIconService* service = new FileIconService(QCoreApplication::instance());
+    return service;
+}
+
+FileIconTicket FileIconService::subscribe(const QString& path, const QSize& size, qreal devicePixelRatio,
+                                          QObject* receiver, Callback callback)
+{
+    FileIconTicket ticket;
+    ticket.m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    if (!receiver || !callback || path.isEmpty()) {
+        ticket.cancel();
+        return ticket;
+    }
+
+    const QString* iconKey = m_iconKeyByPath.object(path);
+    if (iconKey && m_iconsByKey.contains(*iconKey)) {
+        callback(pixmapFor(*iconKey, size, devicePixelRatio)); // Already resolved: no worker, no wait
+        return ticket;
+    }
+
+    m_subscribers[path].append({QPointer<QObject>(receiver), ticket.m_cancelled, size, devicePixelRatio, std::move(callback)});
+    resolve(path);
+    return ticket;
+}
+
+QPixmap FileIconService::cachedIcon(const QString& path, const QSize& size, qreal devicePixelRatio)
+{
+    const QString* iconKey = m_iconKeyByPath.object(path);
+    return iconKey ? pixmapFor(*iconKey, size, devicePixelRatio) : QPixmap();
+}
+
+void FileIconService::resolve(const QString& path)
+{
+    if (m_resolving.contains(path)) return; // The running worker answers every subscriber of path
+    m_resolving.insert(path);
+
+    m_pool.start([this, path]() {
+        // The stat and the MIME sniff are what stall on network mounts and big MIME databases.
+        // The icon itself is built on the GUI thread: QIcon and QPixmap are not safe elsewhere
+        // on every platform, and the shell icon lookup on Windows wants the GUI thread's COM.
+        QFileInfo info(path);
+        info.stat(); // Cached in info, so the GUI thread's look at it does not touch the disk again
+        QString iconKey;
+        if (hasOwnIcon(info)) {
+            iconKey = QStringLiteral("path:") + path;
+        } else {
+            iconKey = QStringLiteral("type:") + (info.isDir() ? QStringLiteral("inode/directory")
+                                                               : QMimeDatabase().mimeTypeForFile(info).name());
+        }
+        qCDebug(lcImage) << "Resolved icon key for" << path << "as" << iconKey;
+        QMetaObject::invokeMethod(this, [this, path, iconKey, info]() {
+            finishResolve(path, iconKey, info);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void FileIconService::finishResolve(const QString& path, const QString& iconKey, const QFileInfo& info)
+{
+    m_resolving.remove(path);
+    if (!m_iconsByKey.contains(iconKey)) {
+        // Once per MIME type, plus once per file that carries its own icon
+        m_iconsByKey.insert(iconKey, new QIcon(m_iconProvider.icon(info)));
+    }
+    m_iconKeyByPath.insert(path, new QString(iconKey));
+
+    const QList<Subscriber> subscribers = m_subscribers.take(path);
+    for (const Subscriber& subscriber : subscribers) {
+        // Checked one by one: an earlier callback may have cancelled a later ticket or deleted its receiver
+        if (subscriber.guard && !subscriber.cancelled->load(std::memory_order_relaxed)) {
+            subscriber.callback(pixmapFor(iconKey, subscriber.size, subscriber.devicePixelRatio));
+        }
+    }
+}
+
+QPixmap FileIconService::pixmapFor(const QString& iconKey, const QSize& size, qreal devicePixelRatio)
+{
+    const QString pixmapKey = QStringLiteral("%1@%2x%3@%4").arg(iconKey).arg(size.width()).arg(size.height()).arg(devicePixelRatio);
+    if (const QPixmap* cached = m_pixmaps.object(pixmapKey)) return *cached;
+
+    const QIcon* icon = m_iconsByKey.object(iconKey);
+    if (!icon || icon->isNull()) return QPixmap();
+    const QPixmap pixmap = icon->pixmap(size, devicePixelRatio); // Rendered once; every widget shares it
+    const qint64 bytes = qint64(pixmap.width()) * pixmap.height() * pixmap.depth() / 8;
+    m_pixmaps.insert(pixmapKey, new QPixmap(pixmap), qMax<qint64>(1, bytes / 1024));
+    return pixmap;
+}
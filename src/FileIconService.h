@@ -0,0 +1,84 @@
+#ifndef FILEICONSERVICE_H
+#define FILEICONSERVICE_H
+
+#include <QObject>
+#include <QCache>
+#include <QHash>
+#include <QIcon>
+#include <QList>
+#include <QFileIconProvider>
+#include <QFileInfo>
+#include <QPixmap>
+#include <QPointer>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+
+// Handle for one subscription. Copies share the same flag; cancel() from any copy wins.
+// A default-constructed ticket is invalid and cancel() on it does nothing.
+class FileIconTicket
+{
+public:
+    void cancel() { if (m_cancelled) m_cancelled->store(true, std::memory_order_relaxed); }
+    bool isValid() const { return m_cancelled != nullptr; }
+
+private:
+    friend class FileIconService;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+// Resolves file and folder icons on its own thread pool, so a stat on a network mount or the first
+// MIME database lookup never stalls the GUI. The icon provider itself runs on the GUI thread, once
+// for each icon key not seen yet. Icons are shared per MIME type; only files that carry
+// their own icon (executables, shortcuts, bundles, .ico files) get one per path. Rendered pixmaps
+// are cached per icon, size and device pixel ratio, and each path is resolved once however many
+// widgets show it. All three caches are LRUs with a fixed limit, so browsing many folders does not
+// grow them without bound; an evicted path is simply resolved again. GUI thread only, apart from
+// the workers.
+class FileIconService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QPixmap&)>; // Null pixmap if no icon could be resolved
+
+    static FileIconService* instance(); // Created on first use on the GUI thread, owned by qApp
+
+    // The callback runs once the icon for path is known: before subscribe() returns if it already is.
+    // It is dropped when the ticket is cancelled or the receiver is destroyed.
+    FileIconTicket subscribe(const QString& path, const QSize& size, qreal devicePixelRatio,
+                             QObject* receiver, Callback callback);
+
+    // Null until path has been resolved once
+    QPixmap cachedIcon(const QString& path, const QSize& size, qreal devicePixelRatio);
+
+private:
+    explicit FileIconService(QObject* parent = nullptr);
+
+    struct Subscriber
+    {
+        QPointer<QObject> guard;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        QSize size;
+        qreal devicePixelRatio;
+        Callback callback;
+    };
+
+    void resolve(const QString& path); // Starts a worker unless one is already running for path
+    void finishResolve(const QString& path, const QString& iconKey, const QFileInfo& info); // Builds the icon if new
+    QPixmap pixmapFor(const QString& iconKey, const QSize& size, qreal devicePixelRatio);
+
+    QThreadPool m_pool; // Separate and small: workers may block on slow mounts
+    QCache<QString, QString> m_iconKeyByPath; // "type:<mime>" or "path:<path>"; cost 1 per path
+    QCache<QString, QIcon> m_iconsByKey;      // Cost 1 per icon; a null icon if the provider had none
+    QCache<QString, QPixmap> m_pixmaps;       // By icon key, size and DPR; cost in KiB
+    QHash<QString, QList<Subscriber>> m_subscribers; // By path, waiting for the first result
+    QSet<QString> m_resolving;
+    QFileIconProvider m_iconProvider; // GUI thread only
+};
+
+#endif // FILEICONSERVICE_H
@@ -1,11 +1,6 @@
 #include "IconData.h"
-#include <QFileInfo>
 
-QString IconData::displayName() const
+IconData::~IconData()
 {
-    return QFileInfo(m_filePath).fileName();
+    IconPathTable::instance().release(m_path); // Frees the entry once no icon uses the path
 }
-
-// Implement setCachedIcon and cachedIcon later if needed
-// void IconData::setCachedIcon(const QPixmap& icon) { m_cachedIcon = icon; }
-// QPixmap IconData::cachedIcon() const { return m_cachedIcon; }
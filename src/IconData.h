@@ -4,33 +4,45 @@
 #include <QString>
 #include <QPointF>
 #include <QUuid>
+#include "IconPathTable.h"
 
 class IconData
 {
 public:
     IconData(const QString& filePath, const QPointF& positionInZone)
-        : m_id(QUuid::createUuid()), m_filePath(filePath), m_positionInZone(positionInZone)
+        : m_id(QUuid::createUuid()), m_path(IconPathTable::instance().intern(filePath)), m_positionInZone(positionInZone)
     {
     }
 
     IconData(QUuid id, const QString& filePath, const QPointF& positionInZone)
-        : m_id(id), m_filePath(filePath), m_positionInZone(positionInZone)
+        : m_id(id), m_path(IconPathTable::instance().intern(filePath)), m_positionInZone(positionInZone)
     {
     }
 
     QUuid id() const { return m_id; }
-    QString filePath() const { return m_filePath; }
+    const QString& filePath() const { return m_path->filePath; }
     QPointF positionInZone() const { return m_positionInZone; }
-    QString displayName() const; // Extracts file name from path
+    const QString& displayName() const { return m_path->fileName; } // Precomputed file name from path
+    const QString& directoryPath() const { return m_path->directory; }
+    const QString& searchKey() const { return m_path->searchKey; } // Lowercase path for filtering
 
-    void setFilePath(const QString& filePath) { m_filePath = filePath; }
+    ~IconData();
+
+    void setFilePath(const QString& filePath)
+    {
+        const IconPathEntry* previous = m_path;
+        m_path = IconPathTable::instance().intern(filePath); // Before releasing, in case it is the same path
+        IconPathTable::instance().release(previous);
+    }
     void setPositionInZone(const QPointF& pos) { m_positionInZone = pos; }
     // void setCachedIcon(const QPixmap& icon); // For later
     // QPixmap cachedIcon() const; // For later
 
 private:
+    Q_DISABLE_COPY(IconData) // Each instance holds one reference on its path entry
+
     QUuid m_id;
-    QString m_filePath;
+    const IconPathEntry* m_path; // Interned, shared by all icons with the same path
     QPointF m_positionInZone; // Relative to its parent ZoneWidget
     // QPixmap m_cachedIcon; // For later optimization
 };
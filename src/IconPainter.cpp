@@ -0,0 +1,76 @@
+#include "IconPainter.h"
+#include "IconData.h"
+#include <QPainter>
+#include <QPixmap>
+#include "StaticTextCache.h"
+
+namespace {
+
+// The base font only changes with the theme, so the derived caption font is built once per base
+QFont captionFont(const QFont& base)
+{
+    static QFont lastBase;
+    static QFont lastCaption;
+    static bool initialized = false;
+    if (!initialized || !(base == lastBase)) {
+        lastBase = base;
+        lastCaption = base;
+        lastCaption.setPointSize(8);
+        initialized = true;
+    }
+    return lastCaption;
+}
+
+}
+
+QSize IconPainter::tileSize()
+{
+    return QSize(80, 60); // Enough for a small icon and a line of text
+}
+
+QSize IconPainter::imageSize()
+{
+    return QSize(32, 32);
+}
+
+void IconPainter::paint(QPainter* painter, const QRect& rect, const IconData* iconData, const QPixmap& image,
+                        bool selected, bool hovered)
+{
+    if (!painter || !iconData) return;
+    painter->save();
+    painter->setRenderHint(QPainter::Antialiasing);
+
+    if (selected) {
+        painter->setPen(QPen(QColor(40, 120, 220), 1));
+        painter->setBrush(QColor(40, 120, 220, 80));
+        painter->drawRoundedRect(QRectF(rect).adjusted(0.5, 0.5, -0.5, -0.5), 6, 6);
+    } else if (hovered) {
+        painter->setPen(Qt::NoPen);
+        painter->setBrush(QColor(255, 255, 255, 40));
+        painter->drawRoundedRect(QRectF(rect), 6, 6);
+    }
+
+    const QSize iconSize = imageSize();
+    QRectF iconRect(rect.x() + (rect.width() - iconSize.width()) / 2.0, rect.y() + 5, iconSize.width(), iconSize.height()); // Centered
+    if (!image.isNull()) {
+        painter->drawPixmap(iconRect.topLeft(), image); // Rendered at the device pixel ratio by FileIconService
+    } else {
+        // Placeholder while the icon is being resolved
+        painter->setBrush(Qt::lightGray);
+        painter->setPen(Qt::darkGray);
+        painter->drawRoundedRect(iconRect, 4, 4);
+    }
+
+    // Display name: two lines at most, laid out once and drawn from the cache
+    painter->setPen(Qt::white); // Adjust text color as needed
+    const QFont font = captionFont(painter->font());
+    painter->setFont(font); // The font the caption was prepared with, so it is not laid out again
+
+    QRectF textRect(rect.x(), iconRect.bottom() + 2, rect.width(), rect.bottom() + 1 - (iconRect.bottom() + 2) - 2);
+    const QStaticText caption = StaticTextCache::text(iconData->displayName(), font, rect.width() - 4, 2,
+                                                      Qt::ElideMiddle, Qt::AlignHCenter);
+    // Centered on the text area like the old AlignCenter; a second line may run into the margins
+    painter->drawStaticText(QPointF(textRect.x() + 2, textRect.center().y() - caption.size().height() / 2.0), caption);
+
+    painter->restore();
+}
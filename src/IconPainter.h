@@ -0,0 +1,23 @@
+#ifndef ICONPAINTER_H
+#define ICONPAINTER_H
+
+#include <QRect>
+#include <QSize>
+
+class QPainter;
+class QPixmap;
+class IconData;
+
+// Draws one icon tile. Shared by IconWidget, which paints itself, and by ZoneWidget when it
+// paints a large zone's icons directly instead of giving each one a child widget.
+namespace IconPainter
+{
+    QSize tileSize();  // Every icon tile has this size, in logical pixels
+    QSize imageSize(); // The file icon inside the tile; the size to ask FileIconService for
+
+    // rect is the tile in the painter's coordinates. A null image draws a placeholder until the icon is resolved.
+    void paint(QPainter* painter, const QRect& rect, const IconData* iconData, const QPixmap& image,
+               bool selected, bool hovered);
+}
+
+#endif // ICONPAINTER_H
@@ -0,0 +1,63 @@
+#include "IconPathTable.h"
+#include <QFileInfo>
+#include <QMutexLocker>
+
+IconPathTable& IconPathTable::instance()
+{
+    static IconPathTable table;
+    return table;
+}
+
+IconPathTable::~IconPathTable()
+{
+    qDeleteAll(m_entries);
+    m_entries.clear();
+}
+
+const IconPathEntry* IconPathTable::intern(const QString& filePath)
+{
+    if (filePath.isEmpty()) {
+        return &m_emptyEntry;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    auto it = m_entries.constFind(filePath);
+    if (it != m_entries.constEnd()) {
+        ++it.value()->refCount;
+        return it.value();
+    }
+
+    // Only place a QFileInfo is built for a given path
+    QFileInfo info(filePath);
+    IconPathEntry* entry = new IconPathEntry;
+    entry->filePath = filePath;
+    entry->fileName = info.fileName();
+    entry->directory = info.path();
+    entry->searchKey = filePath.toLower();
+    entry->refCount = 1;
+    m_entries.insert(filePath, entry);
+    return entry;
+}
+
+void IconPathTable::release(const IconPathEntry* entry)
+{
+    if (!entry || entry == &m_emptyEntry) {
+        return;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    IconPathEntry* owned = m_entries.value(entry->filePath);
+    if (owned != entry) {
+        return; // Not ours; never happens unless released twice
+    }
+    if (--owned->refCount == 0) {
+        m_entries.remove(owned->filePath);
+        delete owned;
+    }
+}
+
+int IconPathTable::count() const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_entries.size();
+}
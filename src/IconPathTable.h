@@ -0,0 +1,43 @@
+#ifndef ICONPATHTABLE_H
+#define ICONPATHTABLE_H
+
+#include <QString>
+#include <QHash>
+#include <QMutex>
+
+// Everything derived from a file path that paint and filter code needs.
+// Computed once per distinct path when the path is interned.
+struct IconPathEntry
+{
+    QString filePath;
+    QString fileName;   // What QFileInfo::fileName() would return
+    QString directory;  // What QFileInfo::path() would return
+    QString searchKey;  // Lowercase full path; the file name is a suffix of it, so one contains() covers both
+    int refCount = 0;   // Holders of this entry; guarded by the table's mutex
+};
+
+// Process-wide interning table for icon file paths.
+// Each distinct path is stored exactly once. intern() takes a reference and release() drops it;
+// an entry is freed with its last reference, so the table only holds paths some icon still uses.
+// The returned pointer stays valid until it is released.
+class IconPathTable
+{
+public:
+    static IconPathTable& instance();
+
+    const IconPathEntry* intern(const QString& filePath);
+    void release(const IconPathEntry* entry); // The empty entry and null are ignored
+    const IconPathEntry* emptyEntry() const { return &m_emptyEntry; }
+    int count() const;
+
+private:
+    IconPathTable() = default;
+    ~IconPathTable();
+    Q_DISABLE_COPY(IconPathTable)
+
+    mutable QMutex m_mutex; // Interning may happen from DB load or UI; lookups through the pointer need no lock
+    QHash<QString, IconPathEntry*> m_entries;
+    IconPathEntry m_emptyEntry;
+};
+
+#endif // ICONPATHTABLE_H
@@ -0,0 +1,96 @@
+#include "IconSpatialIndex.h"
+#include <QSet>
+#include <cmath> // For std::floor
+
+IconSpatialIndex::IconSpatialIndex(int cellSize)
+    : m_cellSize(qMax(1, cellSize))
+{
+}
+
+void IconSpatialIndex::cellRange(const QRect& rect, int& x0, int& y0, int& x1, int& y1) const
+{
+    // floor division so negative coordinates (icons dragged past the edge) land in the right cell
+    x0 = static_cast<int>(std::floor(rect.left() / static_cast<double>(m_cellSize)));
+    y0 = static_cast<int>(std::floor(rect.top() / static_cast<double>(m_cellSize)));
+    x1 = static_cast<int>(std::floor(rect.right() / static_cast<double>(m_cellSize)));
+    y1 = static_cast<int>(std::floor(rect.bottom() / static_cast<double>(m_cellSize)));
+}
+
+void IconSpatialIndex::insert(const QUuid& id, const QRect& rect)
+{
+    if (m_rects.contains(id)) {
+        if (m_rects.value(id) == rect) return;
+        remove(id);
+    }
+    m_rects.insert(id, rect);
+    int x0, y0, x1, y1;
+    cellRange(rect, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            m_cells[cellKey(cx, cy)].append(id);
+        }
+    }
+}
+
+void IconSpatialIndex::remove(const QUuid& id)
+{
+    auto rectIt = m_rects.find(id);
+    if (rectIt == m_rects.end()) return;
+    int x0, y0, x1, y1;
+    cellRange(rectIt.value(), x0, y0, x1, y1);
+    m_rects.erase(rectIt);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            auto cellIt = m_cells.find(cellKey(cx, cy));
+            if (cellIt == m_cells.end()) continue;
+            cellIt.value().removeOne(id);
+            if (cellIt.value().isEmpty()) {
+                m_cells.erase(cellIt);
+            }
+        }
+    }
+}
+
+void IconSpatialIndex::clear()
+{
+    m_cells.clear();
+    m_rects.clear();
+}
+
+QList<QUuid> IconSpatialIndex::query(const QRect& area) const
+{
+    QList<QUuid> result;
+    if (area.isEmpty()) return result;
+
+    QSet<QUuid> seen; // An icon spanning several cells must be reported once
+    int x0, y0, x1, y1;
+    cellRange(area, x0, y0, x1, y1);
+    for (int cy = y0; cy <= y1; ++cy) {
+        for (int cx = x0; cx <= x1; ++cx) {
+            auto cellIt = m_cells.constFind(cellKey(cx, cy));
+            if (cellIt == m_cells.constEnd()) continue;
+            for (const QUuid& id : cellIt.value()) {
+                if (!seen.contains(id) && m_rects.value(id).intersects(area)) {
+                    seen.insert(id);
+                    result.append(id);
+                }
+            }
+        }
+    }
+    return result;
+}
+
+QUuid IconSpatialIndex::itemAt(const QPoint& pos) const
+{
+    int x0, y0, x1, y1;
+    cellRange(QRect(pos, QSize(1, 1)), x0, y0, x1, y1);
+    auto cellIt = m_cells.constFind(cellKey(x0, y0));
+    if (cellIt == m_cells.constEnd()) return QUuid();
+    const QList<QUuid>& ids = cellIt.value();
+    for (int i = ids.size() - 1; i >= 0; --i) {
+        if (m_rects.value(ids.at(i)).contains(pos)) {
+            return ids.at(i);
+        }
+    }
+    return QUuid();
+}
@@ -0,0 +1,38 @@
+#ifndef ICONSPATIALINDEX_H
+#define ICONSPATIALINDEX_H
+
+#include <QHash>
+#include <QList>
+#include <QRect>
+#include <QPoint>
+#include <QUuid>
+
+// Uniform-grid index of icon rectangles within one zone.
+// Each icon is registered in every cell its rect overlaps. A query visits only the cells the
+// query rect covers, so its cost follows the size of the area and the icons in it, not the
+// number of icons in the zone. Icons are all the same small size, so one cell size fits all.
+class IconSpatialIndex
+{
+public:
+    explicit IconSpatialIndex(int cellSize = 64);
+
+    void insert(const QUuid& id, const QRect& rect); // Replaces any previous rect for id
+    void remove(const QUuid& id);
+    void clear();
+    bool contains(const QUuid& id) const { return m_rects.contains(id); }
+    QRect rectOf(const QUuid& id) const { return m_rects.value(id); }
+    int count() const { return m_rects.size(); }
+
+    QList<QUuid> query(const QRect& area) const; // Icons whose rect intersects area
+    QUuid itemAt(const QPoint& pos) const;       // Topmost (last inserted) icon under pos, or null
+
+private:
+    void cellRange(const QRect& rect, int& x0, int& y0, int& x1, int& y1) const;
+    static quint64 cellKey(int cx, int cy) { return (quint64(quint32(cx)) << 32) | quint32(cy); }
+
+    int m_cellSize;
+    QHash<quint64, QList<QUuid>> m_cells;
+    QHash<QUuid, QRect> m_rects;
+};
+
+#endif // ICONSPATIALINDEX_H
@@ -0,0 +1,61 @@
+#include "IconStackData.h"
+#include "IconData.h"
+#include <QDebug>
+#include "Logging.h"
+
+IconStackData::IconStackData(const QString& title, const QPointF& positionInZone)
+    : m_id(QUuid::createUuid()), m_title(title), m_positionInZone(positionInZone)
+{
+}
+
+IconStackData::IconStackData(QUuid id, const QString& title, const QPointF& positionInZone)
+    : m_id(id), m_title(title), m_positionInZone(positionInZone)
+{
+}
+
+IconStackData::~IconStackData()
+{
+    qCDebug(lcZone) << "IconStackData destroyed:" << m_id << m_title << "Clearing" << m_icons.count() << "icons.";
+    qDeleteAll(m_icons);
+    m_icons.clear();
+}
+
+void IconStackData::addIcon(IconData* icon)
+{
+    if (icon && !m_icons.contains(icon)) {
+        m_icons.append(icon);
+    }
+}
+
+IconData* IconStackData::takeIcon(const QUuid& iconId)
+{
+    for (int i = 0; i < m_icons.size(); ++i) {
+        if (m_icons.at(i)->id() == iconId) {
+            return m_icons.takeAt(i);
+        }
+    }
+    return nullptr;
+}
+
+IconData* IconStackData::findIcon(const QUuid& iconId) const
+{
+    for (IconData* icon : m_icons) {
+        if (icon->id() == iconId) {
+            return icon;
+        }
+    }
+    return nullptr;
+}
+
+bool IconStackData::matches(const QString& lowerNeedle) const
+{
+    if (m_title.contains(lowerNeedle, Qt::CaseInsensitive)) {
+        return true;
+    }
+    for (const IconData* icon : m_icons) {
+        if (icon->searchKey().contains(lowerNeedle)) {
+            return true;
+        }
+    }
+    return false;
+}
@@ -0,0 +1,42 @@
+#ifndef ICONSTACKDATA_H
+#define ICONSTACKDATA_H
+
+#include <QString>
+#include <QPointF>
+#include <QUuid>
+#include <QList>
+
+class IconData; // Forward declaration
+
+// A group of icons shown as a single tile in its zone. The stack owns its IconData;
+// icons in a stack are not in ZoneData::icons(), so they get no IconWidget of their own.
+class IconStackData
+{
+public:
+    IconStackData(const QString& title, const QPointF& positionInZone); // For new stacks
+    IconStackData(QUuid id, const QString& title, const QPointF& positionInZone); // For loading from DB
+    ~IconStackData(); // Deletes the icons it still owns
+
+    QUuid id() const { return m_id; }
+    QString title() const { return m_title; }
+    QPointF positionInZone() const { return m_positionInZone; }
+    void setTitle(const QString& title) { m_title = title; }
+    void setPositionInZone(const QPointF& pos) { m_positionInZone = pos; }
+
+    const QList<IconData*>& icons() const { return m_icons; }
+    int count() const { return m_icons.size(); }
+    void addIcon(IconData* icon);           // Takes ownership
+    IconData* takeIcon(const QUuid& iconId); // Releases ownership; nullptr if not in this stack
+    IconData* findIcon(const QUuid& iconId) const;
+
+    // True if the title or any member's search key contains the (already lowercase) needle
+    bool matches(const QString& lowerNeedle) const;
+
+private:
+    QUuid m_id;
+    QString m_title;
+    QPointF m_positionInZone; // Relative to its parent ZoneWidget
+    QList<IconData*> m_icons;
+};
+
+#endif // ICONSTACKDATA_H
@@ -0,0 +1,437 @@
+#include "IconStackWidget.h"
+#include "IconStackData.h"
+#include "IconData.h"
+#include "ZoneWidget.h"
+#include "ZoneData.h"
+#include "PageManager.h"
+
+#include <QPainter>
+#include <QPaintEvent>
+#include <QMouseEvent>
+#include <QContextMenuEvent>
+#include <QHelpEvent>
+#include <QApplication>
+#include <QFrame>
+#include <QLabel>
+#include <QMenu>
+#include <QScrollArea>
+#include <QScrollBar>
+#include <QVBoxLayout>
+#include <QToolTip>
+#include <QInputDialog>
+#include <QMessageBox>
+#include <QDesktopServices>
+#include <QUrl>
+#include <QDebug>
+#include "Logging.h"
+#include <cmath> // For std::round
+
+namespace {
+const int CELL_WIDTH = 80;   // Same footprint as an IconWidget
+const int CELL_HEIGHT = 60;
+const int MAX_COLUMNS = 5;
+const int MAX_VISIBLE_ROWS = 4; // Taller stacks scroll
+
+// Paints every member of the stack as a grid cell, but only the rows inside the exposed rect
+class IconStackGridView : public QWidget
+{
+public:
+    explicit IconStackGridView(IconStackWidget* owner)
+        : QWidget(nullptr), m_owner(owner), m_columns(1)
+    {
+        setAttribute(Qt::WA_OpaquePaintEvent, false);
+    }
+
+    void refresh()
+    {
+        IconStackData* stack = m_owner->data();
+        int count = stack ? stack->count() : 0;
+        m_columns = qBound(1, count, MAX_COLUMNS);
+        int rows = qMax(1, (count + m_columns - 1) / m_columns);
+        setFixedSize(m_columns * CELL_WIDTH, rows * CELL_HEIGHT);
+        update();
+    }
+
+protected:
+    void paintEvent(QPaintEvent *event) override
+    {
+        IconStackData* stack = m_owner->data();
+        if (!stack) return;
+
+        QPainter painter(this);
+        painter.setRenderHint(QPainter::Antialiasing);
+        QFont font = painter.font();
+        font.setPointSize(8);
+        painter.setFont(font);
+
+        const QList<IconData*>& icons = stack->icons();
+        const QRect exposed = event->rect();
+        const int firstRow = qMax(0, exposed.top() / CELL_HEIGHT);
+        const int lastRow = exposed.bottom() / CELL_HEIGHT;
+        for (int row = firstRow; row <= lastRow; ++row) {
+            for (int column = 0; column < m_columns; ++column) {
+                int index = row * m_columns + column;
+                if (index >= icons.size()) return;
+                QRect cell(column * CELL_WIDTH, row * CELL_HEIGHT, CELL_WIDTH, CELL_HEIGHT);
+
+                // Same placeholder glyph as IconWidget
+                QRectF iconRect(cell.x() + CELL_WIDTH / 2.0 - 16, cell.y() + 5, 32, 32);
+                painter.setBrush(Qt::lightGray);
+                painter.setPen(Qt::darkGray);
+                painter.drawRoundedRect(iconRect, 4, 4);
+
+                painter.setPen(palette().color(QPalette::WindowText));
+                QRectF textRect(cell.x(), iconRect.bottom() + 2, CELL_WIDTH, cell.bottom() - iconRect.bottom() - 2);
+                painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap, icons.at(index)->displayName());
+            }
+        }
+    }
+
+    void mouseDoubleClickEvent(QMouseEvent *event) override
+    {
+        if (IconData* icon = iconAt(event->position().toPoint())) {
+            m_owner->launchIcon(icon->id());
+        }
+    }
+
+    void contextMenuEvent(QContextMenuEvent *event) override
+    {
+        IconData* icon = iconAt(event->pos());
+        if (!icon) return;
+        const QUuid iconId = icon->id();
+
+        QMenu contextMenu(this);
+        QAction *launchAction = contextMenu.addAction("Open");
+        QAction *moveOutAction = contextMenu.addAction("Move Out of Stack");
+        contextMenu.addSeparator();
+        QAction *removeAction = contextMenu.addAction("Remove Icon");
+        QAction *chosen = contextMenu.exec(event->globalPos());
+        // The owner may close this popup (and delete this view) while handling the action
+        if (chosen == launchAction) {
+            m_owner->launchIcon(iconId);
+        } else if (chosen == moveOutAction) {
+            m_owner->moveIconOutOfStack(iconId);
+        } else if (chosen == removeAction) {
+            m_owner->removeIconFromStack(iconId);
+        }
+    }
+
+    bool event(QEvent *event) override
+    {
+        if (event->type() == QEvent::ToolTip) {
+            QHelpEvent* helpEvent = static_cast<QHelpEvent*>(event);
+            if (IconData* icon = iconAt(helpEvent->pos())) {
+                QToolTip::showText(helpEvent->globalPos(), icon->filePath(), this);
+            } else {
+                QToolTip::hideText();
+            }
+            return true;
+        }
+        return QWidget::event(event);
+    }
+
+private:
+    IconData* iconAt(const QPoint& pos) const
+    {
+        IconStackData* stack = m_owner->data();
+        if (!stack || pos.x() < 0 || pos.y() < 0) return nullptr;
+        int column = pos.x() / CELL_WIDTH;
+        if (column >= m_columns) return nullptr;
+        int index = (pos.y() / CELL_HEIGHT) * m_columns + column;
+        return index < stack->count() ? stack->icons().at(index) : nullptr;
+    }
+
+    IconStackWidget* m_owner;
+    int m_columns;
+};
+} // namespace
+
+// Popup holding the title and the scrollable grid. Deleted when closed.
+class IconStackPopup : public QFrame
+{
+public:
+    explicit IconStackPopup(IconStackWidget* owner)
+        : QFrame(owner, Qt::Popup), m_owner(owner)
+    {
+        setAttribute(Qt::WA_DeleteOnClose);
+        setObjectName("IconStackPopup"); // For stylesheet targeting
+        setFrameStyle(QFrame::StyledPanel | QFrame::Plain);
+
+        QVBoxLayout* layout = new QVBoxLayout(this);
+        layout->setContentsMargins(6, 6, 6, 6);
+        layout->setSpacing(4);
+        m_titleLabel = new QLabel(this);
+        layout->addWidget(m_titleLabel);
+
+        m_grid = new IconStackGridView(owner);
+        m_scrollArea = new QScrollArea(this);
+        m_scrollArea->setFrameShape(QFrame::NoFrame);
+        m_scrollArea->setHorizontalScrollBarPolicy(Qt::ScrollBarAlwaysOff);
+        m_scrollArea->setWidget(m_grid); // Scroll area takes ownership
+        layout->addWidget(m_scrollArea);
+        refresh();
+    }
+
+    void refresh()
+    {
+        IconStackData* stack = m_owner->data();
+        if (!stack) return;
+        m_titleLabel->setText(QString("%1 (%2)").arg(stack->title()).arg(stack->count()));
+        m_grid->refresh();
+        int scrollBarWidth = m_grid->height() > MAX_VISIBLE_ROWS * CELL_HEIGHT ? m_scrollArea->verticalScrollBar()->sizeHint().width() : 0;
+        m_scrollArea->setFixedSize(m_grid->width() + scrollBarWidth, qMin(m_grid->height(), MAX_VISIBLE_ROWS * CELL_HEIGHT));
+        adjustSize();
+    }
+
+private:
+    IconStackWidget* m_owner;
+    QLabel* m_titleLabel;
+    QScrollArea* m_scrollArea;
+    IconStackGridView* m_grid;
+};
+
+
+IconStackWidget::IconStackWidget(IconStackData* stackData, PageManager* pageManager, ZoneWidget *parentZoneWidget)
+    : QWidget(parentZoneWidget),
+      m_stackData(stackData),
+      m_stackId(stackData ? stackData->id() : QUuid()),
+      m_pageManager(pageManager),
+      m_parentZoneWidget(parentZoneWidget),
+      m_isPressed(false),
+      m_isDragging(false)
+{
+    Q_ASSERT(m_stackData);
+    Q_ASSERT(m_pageManager);
+    Q_ASSERT(m_parentZoneWidget);
+
+    setObjectName("IconStackWidget"); // For stylesheet targeting
+    setFixedSize(CELL_WIDTH, CELL_HEIGHT); // Same footprint as an IconWidget
+    updateFromData();
+    setCursor(Qt::PointingHandCursor);
+
+    setContextMenuPolicy(Qt::CustomContextMenu);
+    connect(this, &QWidget::customContextMenuRequested, this, [this](const QPoint &pos){
+        if (!m_stackData) return;
+        QMenu contextMenu(this);
+        QAction *openAction = contextMenu.addAction("Open Stack");
+        connect(openAction, &QAction::triggered, this, &IconStackWidget::openStack);
+        QAction *renameAction = contextMenu.addAction("Rename Stack...");
+        connect(renameAction, &QAction::triggered, this, &IconStackWidget::renameStackRequested);
+        contextMenu.addSeparator();
+        QAction *ungroupAction = contextMenu.addAction("Ungroup Stack");
+        connect(ungroupAction, &QAction::triggered, this, &IconStackWidget::ungroupStackRequested);
+        contextMenu.exec(mapToGlobal(pos));
+    });
+}
+
+IconStackWidget::~IconStackWidget()
+{
+    qCDebug(lcIcon) << "IconStackWidget for stack" << m_stackId << "destroyed";
+    // IconStackData is owned by ZoneData; the popup is a child and goes with us
+}
+
+void IconStackWidget::updateFromData()
+{
+    if (!m_stackData) return;
+    move(m_stackData->positionInZone().toPoint());
+    setToolTip(QString("%1 - %2 icons").arg(m_stackData->title()).arg(m_stackData->count()));
+    if (m_popup) {
+        m_popup->refresh();
+    }
+    update();
+}
+
+void IconStackWidget::detachData()
+{
+    m_stackData = nullptr;
+    if (m_popup) {
+        m_popup->close();
+    }
+}
+
+void IconStackWidget::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    if (!m_stackData) return;
+
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    // Three offset cards behind each other
+    QRectF cardRect(width()/2.0 - 16, 5, 32, 32);
+    painter.setPen(Qt::darkGray);
+    for (int i = 2; i >= 0; --i) {
+        painter.setBrush(i == 0 ? QColor(Qt::lightGray) : QColor(Qt::gray));
+        painter.drawRoundedRect(cardRect.translated(i * 3 - 3, -i * 3 + 3), 4, 4);
+    }
+
+    // Member count badge
+    QRectF badgeRect(cardRect.right() - 6, cardRect.top() - 2, 18, 14);
+    painter.setBrush(QColor(40, 120, 220));
+    painter.setPen(Qt::NoPen);
+    painter.drawRoundedRect(badgeRect, 7, 7);
+    QFont font = painter.font();
+    font.setPointSize(7);
+    font.setBold(true);
+    painter.setFont(font);
+    painter.setPen(Qt::white);
+    painter.drawText(badgeRect, Qt::AlignCenter, m_stackData->count() > 99 ? QString("99+") : QString::number(m_stackData->count()));
+
+    // Title
+    font.setPointSize(8);
+    font.setBold(false);
+    painter.setFont(font);
+    QRectF textRect(0, cardRect.bottom() + 2, width(), height() - (cardRect.bottom() + 2) - 2);
+    painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap, m_stackData->title());
+}
+
+void IconStackWidget::mousePressEvent(QMouseEvent *event)
+{
+    if (event->button() == Qt::LeftButton) {
+        m_isPressed = true;
+        m_isDragging = false;
+        m_dragStartPosition = event->position().toPoint();
+        event->accept();
+    } else {
+        QWidget::mousePressEvent(event);
+    }
+}
+
+void IconStackWidget::mouseMoveEvent(QMouseEvent *event)
+{
+    if (m_isPressed && (event->buttons() & Qt::LeftButton)) {
+        if (!m_isDragging && (event->position().toPoint() - m_dragStartPosition).manhattanLength() >= QApplication::startDragDistance()) {
+            m_isDragging = true;
+            raise(); // Bring to front while dragging
+        }
+        if (m_isDragging) {
+            QPoint newPos = mapToParent(event->position().toPoint()) - m_dragStartPosition;
+            int constrainedX = qBound(0, newPos.x(), m_parentZoneWidget->width() - width());
+            int constrainedY = qBound(0, newPos.y(), m_parentZoneWidget->height() - height());
+            move(constrainedX, constrainedY);
+        }
+        event->accept();
+    } else {
+        QWidget::mouseMoveEvent(event);
+    }
+}
+
+void IconStackWidget::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (!m_isPressed || event->button() != Qt::LeftButton) {
+        QWidget::mouseReleaseEvent(event);
+        return;
+    }
+    m_isPressed = false;
+    event->accept();
+
+    if (!m_isDragging) {
+        openStack(); // Plain click
+        return;
+    }
+    m_isDragging = false;
+    if (!m_stackData || !m_parentZoneWidget->data()) return;
+
+    // Snap to the same grid as icons
+    QPointF snappedPosition(std::round(pos().x() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE,
+                            std::round(pos().y() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE);
+    snappedPosition.setX(qBound(0.0, snappedPosition.x(), m_parentZoneWidget->width() - static_cast<qreal>(width())));
+    snappedPosition.setY(qBound(0.0, snappedPosition.y(), m_parentZoneWidget->height() - static_cast<qreal>(height())));
+    move(snappedPosition.toPoint());
+    if (m_stackData->positionInZone() != snappedPosition) {
+        m_stackData->setPositionInZone(snappedPosition);
+        m_pageManager->notifyZoneStacksChanged(m_parentZoneWidget->data());
+    }
+}
+
+void IconStackWidget::openStack()
+{
+    if (!m_stackData) return;
+    if (!m_popup) {
+        m_popup = new IconStackPopup(this);
+    }
+    m_popup->refresh();
+    m_popup->move(mapToGlobal(QPoint(0, height())));
+    m_popup->show();
+}
+
+void IconStackWidget::renameStackRequested()
+{
+    if (!m_stackData || !m_parentZoneWidget->data()) return;
+
+    bool ok;
+    QString currentTitle = m_stackData->title();
+    QString newTitle = QInputDialog::getText(this, "Rename Stack", "Enter new stack title:", QLineEdit::Normal, currentTitle, &ok);
+    if (ok && !newTitle.isEmpty() && newTitle != currentTitle && m_stackData) {
+        m_stackData->setTitle(newTitle);
+        m_pageManager->notifyZoneStacksChanged(m_parentZoneWidget->data());
+    }
+}
+
+void IconStackWidget::ungroupStackRequested()
+{
+    ZoneData* zone = m_parentZoneWidget->data();
+    if (!m_stackData || !zone) return;
+
+    PageManager::BatchScope batch(m_pageManager);
+    QList<QUuid> releasedIds = zone->ungroupStack(m_stackId); // Deletes the stack
+    detachData();
+    m_pageManager->notifyIconsAdded(zone, releasedIds);
+    m_pageManager->notifyZoneStacksChanged(zone); // Our ZoneWidget destroys this tile in response
+}
+
+void IconStackWidget::launchIcon(const QUuid& iconId)
+{
+    IconData* icon = m_stackData ? m_stackData->findIcon(iconId) : nullptr;
+    if (!icon) return;
+    if (!QDesktopServices::openUrl(QUrl::fromLocalFile(icon->filePath()))) {
+        qWarning() << "Failed to open URL:" << icon->filePath();
+        QMessageBox::warning(this, "Open Failed",
+                             QString("Could not open the file or application:\n%1\n\nPlease check if the file exists and you have the necessary permissions.").arg(icon->filePath()));
+    }
+}
+
+void IconStackWidget::moveIconOutOfStack(const QUuid& iconId)
+{
+    ZoneData* zone = m_parentZoneWidget->data();
+    if (!m_stackData || !zone) return;
+    IconData* icon = m_stackData->takeIcon(iconId);
+    if (!icon) return;
+
+    // Place it just right of the stack tile, still inside the zone
+    QPointF target = m_stackData->positionInZone() + QPointF(width() + GRID_SIZE, 0);
+    target.setX(qBound(0.0, target.x(), qMax(0.0, m_parentZoneWidget->width() - static_cast<qreal>(width()))));
+    icon->setPositionInZone(target);
+
+    PageManager::BatchScope batch(m_pageManager);
+    zone->addIcon(icon);
+    m_pageManager->notifyIconsAdded(zone, {iconId});
+    deleteStackIfEmpty();
+    m_pageManager->notifyZoneStacksChanged(zone);
+}
+
+void IconStackWidget::removeIconFromStack(const QUuid& iconId)
+{
+    ZoneData* zone = m_parentZoneWidget->data();
+    IconData* icon = m_stackData ? m_stackData->findIcon(iconId) : nullptr;
+    if (!icon || !zone) return;
+
+    QMessageBox::StandardButton reply = QMessageBox::question(this, "Confirm Remove Icon",
+                                                              QString("Are you sure you want to remove icon '%1'?").arg(icon->displayName()),
+                                                              QMessageBox::Yes|QMessageBox::No);
+    if (reply != QMessageBox::Yes || !m_stackData) return;
+
+    delete m_stackData->takeIcon(iconId);
+    PageManager::BatchScope batch(m_pageManager);
+    m_pageManager->notifyIconsRemoved(zone, {iconId}); // Deletes its row
+    deleteStackIfEmpty();
+    m_pageManager->notifyZoneStacksChanged(zone);
+}
+
+void IconStackWidget::deleteStackIfEmpty()
+{
+    ZoneData* zone = m_parentZoneWidget->data();
+    if (!m_stackData || !zone || m_stackData->count() > 0) return;
+    delete zone->takeStack(m_stackId);
+    detachData();
+}
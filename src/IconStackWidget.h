@@ -0,0 +1,61 @@
+#ifndef ICONSTACKWIDGET_H
+#define ICONSTACKWIDGET_H
+
+#include <QWidget>
+#include <QPointer>
+#include <QUuid>
+
+class IconStackData; // Forward declaration
+class IconStackPopup; // Defined in IconStackWidget.cpp
+class ZoneWidget;    // Forward declaration (parent)
+class PageManager;   // Forward declaration
+
+// One tile standing for a whole IconStackData. Clicking it opens a popup grid; the grid is a
+// single painted widget created on open and deleted on close, so the number of widgets stays
+// the same however many icons the stack holds.
+class IconStackWidget : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit IconStackWidget(IconStackData* stackData, PageManager* pageManager, ZoneWidget *parentZoneWidget);
+    ~IconStackWidget() override;
+
+    IconStackData* data() const { return m_stackData; }
+    QUuid stackId() const { return m_stackId; }
+    void updateFromData(); // Position, tile and an open popup
+    void detachData();     // The stack was deleted elsewhere; never touch it again
+
+    // Used by the popup grid
+    void launchIcon(const QUuid& iconId);
+    void moveIconOutOfStack(const QUuid& iconId);
+    void removeIconFromStack(const QUuid& iconId);
+
+protected:
+    void paintEvent(QPaintEvent *event) override;
+    void mousePressEvent(QMouseEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+
+private slots:
+    void openStack();
+    void renameStackRequested();
+    void ungroupStackRequested();
+
+private:
+    void deleteStackIfEmpty(); // After a member left; closes the popup and drops the stack
+
+    IconStackData* m_stackData;
+    QUuid m_stackId; // Kept so the widget can be matched after its data is gone
+    PageManager* m_pageManager;
+    ZoneWidget* m_parentZoneWidget;
+    QPointer<IconStackPopup> m_popup;
+
+    bool m_isPressed;
+    bool m_isDragging;
+    QPoint m_dragStartPosition; // Relative to widget's top-left
+
+    static const int GRID_SIZE = 16; // Same snapping grid as ZoneWidget
+};
+
+#endif // ICONSTACKWIDGET_H
@@ -3,27 +3,26 @@
 #include "ZoneWidget.h"   // For accessing parent zone for bounds, etc.
 #include "ZoneData.h"     // For m_parentZoneWidget->data()
 #include "PageManager.h"  // For notifying changes
+#include "IconPainter.h"
+#include "PerfMonitor.h" // For paint timings on the performance HUD
 
 #include <QPainter>
 #include <QMouseEvent>
 #include <QGuiApplication>
 #include <QScreen>
 #include <QDebug>
-#include <QFileInfo> // For display name
+#include "Logging.h"
 #include <QDesktopServices> // For launching
 #include <QUrl>
-#include <cmath> // For std::round
 #include <QMessageBox> // For confirmations and warnings
 
-// Definition of static const member
-// const int IconWidget::GRID_SIZE; // Not needed if it's const int inside class in C++17
-
 IconWidget::IconWidget(IconData* iconData, PageManager* pageManager, ZoneWidget *parentZoneWidget)
     : QWidget(parentZoneWidget), // Parent is the ZoneWidget
       m_iconData(iconData),
       m_pageManager(pageManager),
       m_parentZoneWidget(parentZoneWidget),
-      m_isDragging(false)
+      m_isDragging(false),
+      m_isSelected(false)
 {
     Q_ASSERT(m_iconData);
     Q_ASSERT(m_pageManager);
@@ -33,7 +32,7 @@ IconWidget::IconWidget(IconData* iconData, PageManager* pageManager, ZoneWidget
     // Set initial geometry and size
     // Icons are typically small, e.g., 64x64 or 32x32 plus text
     // For now, fixed size. Will be dynamic later based on icon image and text.
-    setFixedSize(80, 60); // Width, Height (enough for a small icon and text line)
+    setFixedSize(IconPainter::tileSize());
     updateFromData(); // Sets initial position
 
     setToolTip(m_iconData->filePath());
@@ -42,11 +41,23 @@ IconWidget::IconWidget(IconData* iconData, PageManager* pageManager, ZoneWidget
     // Context menu for removing icon
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QWidget::customContextMenuRequested, this, [this](const QPoint &pos){
+        if (!m_iconData) return;
+        // Right-clicking outside the selection makes this icon the selection
+        if (!m_isSelected) {
+            m_parentZoneWidget->clearSelection();
+            m_parentZoneWidget->setIconSelected(m_iconData->id(), true);
+        }
+        int selectedCount = m_parentZoneWidget->selectedIconCount();
+
         QMenu contextMenu(this);
-        QAction *launchAction = contextMenu.addAction("Open");
-        connect(launchAction, &QAction::triggered, this, &IconWidget::launchFileRequested);
+        if (selectedCount == 1) {
+            QAction *launchAction = contextMenu.addAction("Open");
+            connect(launchAction, &QAction::triggered, this, &IconWidget::launchFileRequested);
+            contextMenu.addSeparator();
+        }
+        m_parentZoneWidget->addSendToZoneMenu(&contextMenu);
         contextMenu.addSeparator();
-        QAction *removeAction = contextMenu.addAction("Remove Icon");
+        QAction *removeAction = contextMenu.addAction(selectedCount > 1 ? QString("Remove %1 Selected Icons").arg(selectedCount) : QString("Remove Icon"));
         connect(removeAction, &QAction::triggered, this, &IconWidget::removeIconRequested);
         contextMenu.exec(mapToGlobal(pos));
     });
@@ -54,7 +65,8 @@ IconWidget::IconWidget(IconData* iconData, PageManager* pageManager, ZoneWidget
 
 IconWidget::~IconWidget()
 {
-    qDebug() << "IconWidget for" << (m_iconData ? m_iconData->filePath() : "Unknown") << "destroyed";
+    m_fileIconTicket.cancel();
+    qCDebug(lcIcon) << "IconWidget for" << (m_iconData ? m_iconData->filePath() : "Unknown") << "destroyed";
     // IconData is owned by ZoneData, not by IconWidget
 }
 
@@ -62,44 +74,71 @@ void IconWidget::updateFromData()
 {
     if (!m_iconData) return;
     move(m_iconData->positionInZone().toPoint());
+    requestFileIcon();
     update(); // Trigger repaint for name change or visual state
 }
 
+void IconWidget::requestFileIcon()
+{
+    if (!m_iconData || m_iconData->filePath() == m_fileIconPath) return;
+    m_fileIconPath = m_iconData->filePath();
+    m_fileIconTicket.cancel();
+    m_fileIcon = QPixmap(); // Placeholder until the new icon arrives
+    m_fileIconPending = true; // Cleared right away if the icon is already resolved
+    m_fileIconTicket = FileIconService::instance()->subscribe(m_fileIconPath, IconPainter::imageSize(), devicePixelRatioF(), this,
+                                                               [this](const QPixmap& icon) {
+        m_fileIcon = icon;
+        m_fileIconPending = false;
+        update();
+        if (m_parentZoneWidget) m_parentZoneWidget->notifyContentReady(geometry()); // Also for a hidden page's snapshot
+    });
+}
+
+void IconWidget::setParentZoneWidget(ZoneWidget* zoneWidget, IconData* iconData)
+{
+    m_parentZoneWidget = zoneWidget;
+    m_iconData = iconData; // Same IconData object; only its owning zone changed
+    m_isDragging = false;
+    if (parentWidget() != zoneWidget) {
+        setParent(zoneWidget); // setParent hides the widget
+    }
+    updateFromData();
+    show();
+}
+
+void IconWidget::setSelected(bool selected)
+{
+    if (m_isSelected != selected) {
+        m_isSelected = selected;
+        update();
+    }
+}
+
 void IconWidget::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
+    PerfMonitor::PaintScope paintTiming(PerfMonitor::PaintKind::Icon,
+                                        [this] { return m_iconData ? m_iconData->displayName() : QString(); });
     QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
-
-    if (!m_iconData) return;
-
-    // Simple background (optional, can be transparent)
-    // painter.fillRect(rect(), QColor(200, 200, 200, 50));
-
-    // Placeholder for icon image (e.g., a generic file icon)
-    // For now, just a rectangle
-    QRectF iconRect(width()/2.0 - 16, 5, 32, 32); // Centered 32x32 icon placeholder
-    painter.setBrush(Qt::lightGray);
-    painter.setPen(Qt::darkGray);
-    painter.drawRoundedRect(iconRect, 4, 4);
-    // painter.drawPixmap(iconRect.topLeft(), m_iconData->cachedIcon()); // For later
-
-    // Display name
-    painter.setPen(Qt::white); // Adjust text color as needed
-    QFont font = painter.font();
-    font.setPointSize(8);
-    painter.setFont(font);
-
-    QRectF textRect(0, iconRect.bottom() + 2, width(), height() - (iconRect.bottom() + 2) - 2);
-    painter.drawText(textRect, Qt::AlignCenter | Qt::TextWordWrap, m_iconData->displayName());
+    IconPainter::paint(&painter, rect(), m_iconData, m_fileIcon, m_isSelected, false); // Same tile ZoneWidget paints for large zones
 }
 
 void IconWidget::mousePressEvent(QMouseEvent *event)
 {
-    if (event->button() == Qt::LeftButton) {
+    if (event->button() == Qt::LeftButton && m_iconData) {
+        m_parentZoneWidget->setFocus(Qt::MouseFocusReason); // For Delete/Escape on the selection
+        if (event->modifiers() & Qt::ControlModifier) {
+            m_parentZoneWidget->setIconSelected(m_iconData->id(), !m_isSelected); // Toggle, no drag
+            event->accept();
+            return;
+        }
+        if (!m_isSelected) {
+            m_parentZoneWidget->clearSelection(); // Plain click on an unselected icon drags just this icon
+        }
         m_isDragging = true;
-        m_dragStartPosition = event->position().toPoint(); // Position of click relative to widget's top-left
-        raise(); // Bring to front while dragging
+        // The zone shows a ghost while dragging; this widget moves once, on release
+        m_parentZoneWidget->beginIconDrag(m_iconData->id(), mapToParent(event->position().toPoint()));
+        raise(); // On top where it lands
         event->accept();
     } else {
         QWidget::mousePressEvent(event);
@@ -109,17 +148,7 @@ void IconWidget::mousePressEvent(QMouseEvent *event)
 void IconWidget::mouseMoveEvent(QMouseEvent *event)
 {
     if (m_isDragging && (event->buttons() & Qt::LeftButton)) {
-        // Calculate new top-left position for the widget, relative to its parent (ZoneWidget)
-        QPoint newPos = mapToParent(event->position().toPoint()) - m_dragStartPosition;
-
-        // Constrain within parent (ZoneWidget) bounds
-        if (m_parentZoneWidget) {
-            int constrainedX = qBound(0, newPos.x(), m_parentZoneWidget->width() - width());
-            int constrainedY = qBound(0, newPos.y(), m_parentZoneWidget->height() - height());
-            newPos = QPoint(constrainedX, constrainedY);
-        }
-
-        move(newPos);
+        m_parentZoneWidget->updateIconDrag(event->globalPosition().toPoint());
         event->accept();
     } else {
         QWidget::mouseMoveEvent(event);
@@ -130,31 +159,9 @@ void IconWidget::mouseReleaseEvent(QMouseEvent *event)
 {
     if (m_isDragging && event->button() == Qt::LeftButton) {
         m_isDragging = false;
-        if (m_iconData && m_parentZoneWidget) {
-            QPointF currentPos = pos(); // Current position is relative to parent (ZoneWidget)
-
-            // Snap to grid
-            qreal snappedX = std::round(currentPos.x() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE;
-            qreal snappedY = std::round(currentPos.y() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE;
-            QPointF snappedPositionInZone(snappedX, snappedY);
-
-            // Ensure snapped position is also within bounds (though dragging should already ensure this)
-            snappedPositionInZone.setX(qBound(0.0, snappedPositionInZone.x(), m_parentZoneWidget->width() - static_cast<qreal>(width())));
-            snappedPositionInZone.setY(qBound(0.0, snappedPositionInZone.y(), m_parentZoneWidget->height() - static_cast<qreal>(height())));
-
-            if (m_iconData->positionInZone() != snappedPositionInZone) {
-                m_iconData->setPositionInZone(snappedPositionInZone);
-                move(snappedPositionInZone.toPoint()); // Move widget to snapped position
-                qDebug() << "Icon" << m_iconData->id() << "snapped and moved to" << snappedPositionInZone
-                         << "in zone" << m_parentZoneWidget->data()->id();
-                if (m_parentZoneWidget->data()) {
-                    m_pageManager->updateZoneData(m_parentZoneWidget->data());
-                }
-            } else if (pos() != snappedPositionInZone.toPoint()) {
-                // If data didn't change but widget position isn't snapped (e.g. initial placement), snap it.
-                move(snappedPositionInZone.toPoint());
-            }
-        }
+        // Snaps and stores the dragged icons, or hands them to the zone under the cursor.
+        // Either way this widget may have a new position or a new parent zone afterwards.
+        m_parentZoneWidget->finishIconDrag(event->globalPosition().toPoint());
         event->accept();
     } else {
         QWidget::mouseReleaseEvent(event);
@@ -182,6 +189,11 @@ void IconWidget::removeIconRequested()
 {
     if (!m_iconData || !m_parentZoneWidget || !m_parentZoneWidget->data() || !m_pageManager) return;
 
+    if (m_isSelected && m_parentZoneWidget->selectedIconCount() > 1) {
+        m_parentZoneWidget->removeSelectedIcons(); // One confirmation and one batch for all of them
+        return;
+    }
+
     ZoneData* zd = m_parentZoneWidget->data();
     QUuid iconIdToRemove = m_iconData->id();
     QString iconName = m_iconData->displayName();
@@ -196,10 +208,10 @@ void IconWidget::removeIconRequested()
                  << "from zone" << zd->title() << "ID" << zd->id();
 
         if (zd->removeIcon(iconIdToRemove)) { // This also deletes IconData from ZoneData's list
-            m_pageManager->updateZoneData(zd); // Notify that zone content changed
-            // The IconWidget is a child of ZoneWidget. ZoneWidget::loadOrUpdateIcons
-            // (triggered by updateZoneData via PageTabContentWidget) will notice this icon
-            // is gone from ZoneData and will delete the IconWidget instance.
+            m_iconData = nullptr; // Deleted by removeIcon; don't touch it again
+            // The IconWidget is a child of ZoneWidget. ZoneWidget::applyIconsRemoved
+            // (reached via PageTabContentWidget) hides and deletes this IconWidget instance.
+            m_pageManager->notifyIconsRemoved(zd, {iconIdToRemove});
         } else {
             qWarning() << "Failed to remove icon from ZoneData. Icon ID:" << iconIdToRemove;
             QMessageBox::warning(this, "Remove Failed", "Could not remove the icon from data.");
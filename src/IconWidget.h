@@ -4,6 +4,8 @@
 #include <QWidget>
 #include <QPointF>
 #include <QMenu>
+#include <QPixmap>
+#include "FileIconService.h" // For FileIconTicket
 
 class IconData;   // Forward declaration
 class ZoneWidget; // Forward declaration (parent)
@@ -19,6 +21,12 @@ public:
 
     IconData* data() const { return m_iconData; }
     void updateFromData(); // Update widget appearance/position from m_iconData
+    void detachData() { m_iconData = nullptr; } // The IconData left this zone or was deleted
+    void setParentZoneWidget(ZoneWidget* zoneWidget, IconData* iconData); // Handed to another zone
+
+    bool isSelected() const { return m_isSelected; }
+    bool isFileIconPending() const { return m_fileIconPending; } // Placeholder shown until FileIconService answers
+    void setSelected(bool selected);
 
 protected:
     void paintEvent(QPaintEvent *event) override;
@@ -34,14 +42,18 @@ private slots:
     void launchFileRequested();
 
 private:
+    void requestFileIcon(); // Subscribes to the icon for the current path, if it changed
+
     IconData* m_iconData;
     PageManager* m_pageManager; // To notify of changes that need saving (via ZoneData)
     ZoneWidget* m_parentZoneWidget; // To access parent zone's data/methods if needed
 
-    bool m_isDragging;
-    QPoint m_dragStartPosition; // Relative to widget's top-left, for dragging
-
-    static const int GRID_SIZE = 16; // Grid size for snapping
+    bool m_isDragging; // The parent zone runs the drag; this only forwards the mouse to it
+    bool m_isSelected;
+    QString m_fileIconPath;     // Path m_fileIcon was requested for
+    QPixmap m_fileIcon;         // Null while FileIconService resolves it
+    bool m_fileIconPending = false;
+    FileIconTicket m_fileIconTicket;
 };
 
 #endif // ICONWIDGET_H
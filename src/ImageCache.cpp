@@ -0,0 +1,91 @@
+#include "ImageCache.h"
+#include <QDebug>
+#include "Logging.h"
+
+ImageCache::ImageCache(qint64 budgetBytes)
+    : m_budgetBytes(budgetBytes), m_usedBytes(0), m_hits(0), m_misses(0), m_evictions(0)
+{
+}
+
+QImage ImageCache::find(const ImageCacheKey& key, qint64* modifiedMsecs)
+{
+    auto indexIt = m_index.constFind(key);
+    if (indexIt == m_index.constEnd()) {
+        ++m_misses;
+        return QImage();
+    }
+    ++m_hits;
+    m_entries.splice(m_entries.begin(), m_entries, indexIt.value()); // Move to front; iterators stay valid
+    if (modifiedMsecs) *modifiedMsecs = m_entries.front().modifiedMsecs;
+    return m_entries.front().image;
+}
+
+void ImageCache::insert(const ImageCacheKey& key, const QImage& image, qint64 modifiedMsecs)
+{
+    if (image.isNull()) return;
+    const qint64 bytes = image.sizeInBytes();
+    if (bytes > m_budgetBytes) {
+        qCDebug(lcImage) << "Not caching" << key.path << "-" << bytes << "bytes exceeds the whole budget";
+        return;
+    }
+
+    remove(key);
+    m_entries.push_front({key, image, bytes, modifiedMsecs});
+    m_index.insert(key, m_entries.begin());
+    m_usedBytes += bytes;
+    evictToBudget();
+}
+
+bool ImageCache::contains(const ImageCacheKey& key, qint64* modifiedMsecs) const
+{
+    auto indexIt = m_index.constFind(key);
+    if (indexIt == m_index.constEnd()) return false;
+    if (modifiedMsecs) *modifiedMsecs = indexIt.value()->modifiedMsecs;
+    return true;
+}
+
+void ImageCache::remove(const ImageCacheKey& key)
+{
+    auto indexIt = m_index.find(key);
+    if (indexIt == m_index.end()) return;
+    m_usedBytes -= indexIt.value()->bytes;
+    m_entries.erase(indexIt.value());
+    m_index.erase(indexIt);
+}
+
+void ImageCache::setBudget(qint64 budgetBytes)
+{
+    m_budgetBytes = qMax<qint64>(0, budgetBytes);
+    evictToBudget();
+}
+
+void ImageCache::clear()
+{
+    m_entries.clear();
+    m_index.clear();
+    m_usedBytes = 0;
+}
+
+ImageCache::Stats ImageCache::stats() const
+{
+    Stats stats;
+    stats.hits = m_hits;
+    stats.misses = m_misses;
+    stats.evictions = m_evictions;
+    stats.usedBytes = m_usedBytes;
+    stats.budgetBytes = m_budgetBytes;
+    stats.entries = m_index.size();
+    return stats;
+}
+
+void ImageCache::evictToBudget()
+{
+    while (m_usedBytes > m_budgetBytes && !m_entries.empty()) {
+        const Entry& oldest = m_entries.back();
+        qCDebug(lcImage) << "Evicting" << oldest.key.path << oldest.key.size << oldest.bytes << "bytes";
+        m_usedBytes -= oldest.bytes;
+        m_index.remove(oldest.key);
+        m_entries.pop_back();
+        ++m_evictions;
+    }
+}
@@ -0,0 +1,76 @@
+#ifndef IMAGECACHE_H
+#define IMAGECACHE_H
+
+#include <QHash>
+#include <QImage>
+#include <QSize>
+#include <QString>
+#include <list>
+
+// Identifies one decoded and processed version of an image file
+struct ImageCacheKey
+{
+    QString path;
+    QSize size;               // Decoded size; invalid means the file's own size
+    int blurRadius = 0;       // Processing applied after decoding
+
+    bool operator==(const ImageCacheKey& other) const
+    {
+        return path == other.path && size == other.size && blurRadius == other.blurRadius;
+    }
+};
+
+inline size_t qHash(const ImageCacheKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.path, key.size.width(), key.size.height(), key.blurRadius);
+}
+
+// Process-wide LRU of decoded images with a byte budget. QImage is implicitly shared, so a hit hands
+// out a handle to the same pixels the cache holds; an evicted image lives on while a widget uses it.
+// Each entry remembers the file's mtime at decode time so the owner can drop it once the file changes.
+// GUI thread only: ImageDecodeService looks up and inserts there.
+class ImageCache
+{
+public:
+    struct Stats
+    {
+        quint64 hits = 0;
+        quint64 misses = 0;
+        quint64 evictions = 0;
+        qint64 usedBytes = 0;
+        qint64 budgetBytes = 0;
+        int entries = 0;
+    };
+
+    explicit ImageCache(qint64 budgetBytes = 256 * 1024 * 1024);
+
+    // Null on a miss; a hit becomes the most recent entry and reports the mtime it was stored with
+    QImage find(const ImageCacheKey& key, qint64* modifiedMsecs = nullptr);
+    void insert(const ImageCacheKey& key, const QImage& image, qint64 modifiedMsecs);
+    void remove(const ImageCacheKey& key);
+    bool contains(const ImageCacheKey& key, qint64* modifiedMsecs = nullptr) const; // No LRU or stats update
+    void setBudget(qint64 budgetBytes);    // Evicts right away if the cache is over the new budget
+    void clear();
+    Stats stats() const;
+
+private:
+    struct Entry
+    {
+        ImageCacheKey key;
+        QImage image;
+        qint64 bytes;
+        qint64 modifiedMsecs; // File mtime when it was decoded
+    };
+
+    void evictToBudget();
+
+    std::list<Entry> m_entries; // Most recently used first
+    QHash<ImageCacheKey, std::list<Entry>::iterator> m_index;
+    qint64 m_budgetBytes;
+    qint64 m_usedBytes;
+    quint64 m_hits;
+    quint64 m_misses;
+    quint64 m_evictions;
+};
+
+#endif // IMAGECACHE_H
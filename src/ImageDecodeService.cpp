@@ -0,0 +1,229 @@
+#include "ImageDecodeService.h"
+#include "BlurEngine.h"
+#include "PerfMonitor.h" // For decode timings on the performance HUD
+#include <QCoreApplication>
+#include <QDateTime>
+#include <QElapsedTimer>
+#include <QFileInfo>
+#include <QImageReader>
+#include <QMutex>
+#include <QThread>
+#include <QtMath> // For qCeil
+#include <QDebug>
+#include "Logging.h"
+
+// The worker only needs to know whether anyone still wants the result
+struct ImageDecodeService::DecodeJob
+{
+    QMutex mutex;
+    QList<std::shared_ptr<std::atomic<bool>>> flags; // One per waiter; appended on the GUI thread
+
+    void addWaiter(const std::shared_ptr<std::atomic<bool>>& flag)
+    {
+        QMutexLocker locker(&mutex);
+        flags.append(flag);
+    }
+
+    bool allCancelled()
+    {
+        QMutexLocker locker(&mutex);
+        for (const auto& flag : flags) {
+            if (!flag->load(std::memory_order_relaxed)) return false;
+        }
+        return true;
+    }
+};
+
+ImageDecodeService::ImageDecodeService(QObject* parent)
+    : QObject(parent)
+{
+    // Leave cores for the GUI thread and the blur's own row bands
+    m_pool.setMaxThreadCount(qMax(1, QThread::idealThreadCount() / 2));
+}
+
+ImageDecodeService* ImageDecodeService::instance()
+{
+    static ImageDecodeService* service = new ImageDecodeService(QCoreApplication::instance());
+    return service;
+}
+
+QSize ImageDecodeService::bucketedSize(const QSize& deviceSize)
+{
+    const int step = 128;
+    return QSize((qMax(1, deviceSize.width()) + step - 1) / step * step,
+                 (qMax(1, deviceSize.height()) + step - 1) / step * step);
+}
+
+bool ImageDecodeService::exceeds(const QSize& needed, const QSize& requested)
+{
+    return !requested.isValid() ? false : (needed.width() > requested.width() || needed.height() > requested.height());
+}
+
+QImage ImageDecodeService::decodeNow(const ImageDecodeRequest& request, ImageDecodeTimings* timings)
+{
+    QElapsedTimer timer;
+    timer.start();
+    QImageReader reader(request.path);
+    reader.setAutoTransform(true); // Honour EXIF orientation
+    if (request.targetSize.isValid()) {
+        // Decode just large enough to cover the target. The JPEG plugin turns this into a DCT-domain
+        // scaled decode (1/2, 1/4, 1/8) before its final resample, so the full image never exists.
+        QSize sourceSize = reader.size(); // From the header; before any EXIF rotation
+        const bool rotated = reader.transformation() & QImageIOHandler::TransformationRotate90;
+        if (sourceSize.isValid()) {
+            if (rotated) sourceSize.transpose();
+            const qreal factor = qMax(request.targetSize.width() / qreal(sourceSize.width()),
+                                      request.targetSize.height() / qreal(sourceSize.height()));
+            if (factor < 1.0) {
+                QSize scaledSize(qCeil(sourceSize.width() * factor), qCeil(sourceSize.height() * factor));
+                if (rotated) scaledSize.transpose(); // setScaledSize applies before the rotation
+                reader.setScaledSize(scaledSize);
+                qCDebug(lcImage) << "Decoding" << request.path << "at" << scaledSize << "instead of" << reader.size();
+            }
+        }
+    }
+    QImage image = reader.read();
+    if (timings) timings->decodeNsecs = timer.nsecsElapsed();
+    if (image.isNull()) {
+        qCDebug(lcImage) << "Decode failed for" << request.path << ":" << reader.errorString();
+        return image;
+    }
+    // The format QPixmap::fromImage converts to anyway, and the one the blur works on
+    image = image.convertToFormat(QImage::Format_ARGB32_Premultiplied);
+    if (request.blurRadius > 0) {
+        BlurEngine::blur(image, request.blurRadius, request.blurRadius);
+    }
+    if (timings) timings->processNsecs = timer.nsecsElapsed() - timings->decodeNsecs;
+    return image;
+}
+
+ImageCacheKey ImageDecodeService::keyFor(const ImageDecodeRequest& request)
+{
+    ImageCacheKey key;
+    key.path = request.path;
+    key.size = request.targetSize;
+    key.blurRadius = request.blurRadius;
+    return key;
+}
+
+qint64 ImageDecodeService::modifiedMsecs(const QString& path)
+{
+    const QFileInfo info(path);
+    return info.exists() ? info.lastModified().toMSecsSinceEpoch() : 0;
+}
+
+ImageDecodeTicket ImageDecodeService::decode(const ImageDecodeRequest& request, QObject* receiver, Callback callback)
+{
+    ImageDecodeTicket ticket;
+    ticket.m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    if (!receiver || !callback) {
+        ticket.cancel();
+        return ticket;
+    }
+
+    const ImageCacheKey key = keyFor(request);
+    qint64 cachedMsecs = 0;
+    const QImage cached = m_cache.find(key, &cachedMsecs);
+    if (!cached.isNull()) {
+        qCDebug(lcImage) << "Cache hit for" << request.path << cached.size();
+        callback(cached); // Shares the cached pixels; nothing is copied
+        revalidate(key, cachedMsecs);
+        return ticket;
+    }
+
+    Waiter waiter{QPointer<QObject>(receiver), ticket.m_cancelled, std::move(callback)};
+    auto inFlightIt = m_inFlight.find(key);
+    if (inFlightIt != m_inFlight.end()) {
+        qCDebug(lcImage) << "Joining the decode already running for" << request.path;
+        inFlightIt->job->addWaiter(waiter.cancelled);
+        inFlightIt->waiters.append(waiter);
+        return ticket;
+    }
+
+    InFlight& inFlight = m_inFlight[key];
+    inFlight.request = request;
+    inFlight.waiters.append(waiter);
+    startJob(key, inFlight);
+    return ticket;
+}
+
+void ImageDecodeService::startJob(const ImageCacheKey& key, InFlight& inFlight)
+{
+    auto job = std::make_shared<DecodeJob>();
+    for (const Waiter& waiter : inFlight.waiters) {
+        job->addWaiter(waiter.cancelled);
+    }
+    inFlight.job = job;
+
+    const ImageDecodeRequest request = inFlight.request;
+    m_pool.start([this, key, request, job]() {
+        // Always report back, even when abandoned, so the in-flight entry is released on the GUI thread
+        QImage image;
+        qint64 msecs = 0;
+        ImageDecodeTimings timings;
+        bool aborted = job->allCancelled(); // Superseded while queued
+        if (!aborted) {
+            msecs = modifiedMsecs(request.path); // Before reading, so an edit during the decode is caught next time
+            image = decodeNow(request, &timings);
+            aborted = job->allCancelled();
+        }
+        qCDebug(lcImage) << (aborted ? "Abandoned" : "Decoded") << request.path << image.size() << "blur" << request.blurRadius;
+        QMetaObject::invokeMethod(this, [this, key, image, msecs, timings, aborted]() {
+            finishJob(key, image, msecs, timings, aborted);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ImageDecodeService::finishJob(const ImageCacheKey& key, const QImage& image, qint64 modifiedMsecs,
+                                   const ImageDecodeTimings& timings, bool aborted)
+{
+    auto inFlightIt = m_inFlight.find(key);
+    if (inFlightIt == m_inFlight.end()) return;
+
+    // Drop waiters whose ticket was cancelled or whose receiver is gone
+    QList<Waiter> live;
+    for (const Waiter& waiter : std::as_const(inFlightIt->waiters)) {
+        if (waiter.guard && !waiter.cancelled->load(std::memory_order_relaxed)) live.append(waiter);
+    }
+
+    if (aborted) {
+        if (live.isEmpty()) {
+            m_inFlight.erase(inFlightIt);
+        } else {
+            inFlightIt->waiters = live; // Someone joined after the worker gave up: decode after all
+            startJob(key, *inFlightIt);
+        }
+        return;
+    }
+
+    m_inFlight.erase(inFlightIt);
+    if (PerfMonitor::isEnabled()) {
+        PerfMonitor::instance()->recordDecode(key.path, timings.decodeNsecs, timings.processNsecs);
+    }
+    if (!image.isNull()) {
+        m_cache.insert(key, image, modifiedMsecs);
+    }
+    for (const Waiter& waiter : std::as_const(live)) {
+        // Checked again: an earlier callback may have cancelled a later ticket or deleted its receiver
+        if (waiter.guard && !waiter.cancelled->load(std::memory_order_relaxed)) {
+            waiter.callback(image);
+        }
+    }
+}
+
+void ImageDecodeService::revalidate(const ImageCacheKey& key, qint64 cachedMsecs)
+{
+    if (m_revalidating.contains(key)) return;
+    m_revalidating.insert(key);
+    m_pool.start([this, key, cachedMsecs]() {
+        const qint64 msecs = modifiedMsecs(key.path);
+        QMetaObject::invokeMethod(this, [this, key, cachedMsecs, msecs]() {
+            m_revalidating.remove(key);
+            if (msecs == cachedMsecs) return;
+            qint64 current = 0;
+            if (!m_cache.contains(key, &current) || current != cachedMsecs) return; // Replaced meanwhile
+            qCDebug(lcImage) << "Dropping cached" << key.path << key.size << "- the file changed on disk";
+            m_cache.remove(key);
+        }, Qt::QueuedConnection);
+    });
+}
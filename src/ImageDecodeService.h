@@ -0,0 +1,106 @@
+#ifndef IMAGEDECODESERVICE_H
+#define IMAGEDECODESERVICE_H
+
+#include <QObject>
+#include <QHash>
+#include <QImage>
+#include <QList>
+#include <QPointer>
+#include <QSet>
+#include <QSize>
+#include <QString>
+#include <QThreadPool>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include "ImageCache.h"
+
+// What to decode and how to process it before it is handed back
+struct ImageDecodeRequest
+{
+    QString path;
+    QSize targetSize;   // Device pixels the image must cover; invalid decodes at the file's own size
+    int blurRadius = 0; // BlurEngine box radius per pass; 0 leaves the image as decoded
+};
+
+// Where a decode's time went, for the performance HUD
+struct ImageDecodeTimings
+{
+    qint64 decodeNsecs = 0;  // QImageReader::read(), including its scaled decode
+    qint64 processNsecs = 0; // Format conversion and blur
+};
+
+// Handle for one pending decode. Copies share the same flag; cancel() from any copy wins.
+// A default-constructed ticket is invalid and cancel() on it does nothing.
+class ImageDecodeTicket
+{
+public:
+    void cancel() { if (m_cancelled) m_cancelled->store(true, std::memory_order_relaxed); }
+    bool isValid() const { return m_cancelled != nullptr; }
+    bool isCancelled() const { return m_cancelled && m_cancelled->load(std::memory_order_relaxed); }
+
+private:
+    friend class ImageDecodeService;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+// Decodes images with QImageReader on its own thread pool, so a large JPEG never stalls the GUI.
+// Results come back on the GUI thread through the callback, unless the ticket was cancelled or the
+// receiver was destroyed in the meantime. Finished images go into a shared ImageCache: a request
+// that hits it is answered at once, and requests for an image already being decoded wait for that
+// decode instead of starting another. The GUI thread never touches the file system: a hit is
+// checked against the file's mtime on the pool afterwards, and a changed file drops the entry so
+// the next request decodes it again.
+class ImageDecodeService : public QObject
+{
+    Q_OBJECT
+
+public:
+    using Callback = std::function<void(const QImage&)>; // Null image if the file could not be read
+
+    static ImageDecodeService* instance(); // Created on first use on the GUI thread, owned by qApp
+
+    // On a cache hit the callback runs before decode() returns
+    ImageDecodeTicket decode(const ImageDecodeRequest& request, QObject* receiver, Callback callback);
+
+    // The worker body: read, auto-rotate, convert and process. Safe to call from any thread.
+    static QImage decodeNow(const ImageDecodeRequest& request, ImageDecodeTimings* timings = nullptr);
+
+    // Target sizes are rounded up to a coarse grid, so nearby sizes share one cache entry
+    // and a widget re-decodes only after growing past the size it asked for
+    static QSize bucketedSize(const QSize& deviceSize);
+    static bool exceeds(const QSize& needed, const QSize& requested); // Needed larger in either dimension
+
+    ImageCache& cache() { return m_cache; }
+
+private:
+    explicit ImageDecodeService(QObject* parent = nullptr);
+
+    struct Waiter
+    {
+        QPointer<QObject> guard;
+        std::shared_ptr<std::atomic<bool>> cancelled;
+        Callback callback;
+    };
+    struct DecodeJob; // Shared with the worker; defined in the .cpp
+    struct InFlight
+    {
+        ImageDecodeRequest request;
+        std::shared_ptr<DecodeJob> job;
+        QList<Waiter> waiters;
+    };
+
+    static ImageCacheKey keyFor(const ImageDecodeRequest& request); // Path, size and blur; no disk access
+    static qint64 modifiedMsecs(const QString& path);                // 0 if the file is missing; worker only
+    void startJob(const ImageCacheKey& key, InFlight& inFlight);
+    void finishJob(const ImageCacheKey& key, const QImage& image, qint64 modifiedMsecs,
+                   const ImageDecodeTimings& timings, bool aborted);
+    void revalidate(const ImageCacheKey& key, qint64 cachedMsecs);
+
+    QThreadPool m_pool; // Separate from the global pool, which the blur uses for its row bands
+    ImageCache m_cache;
+    QHash<ImageCacheKey, InFlight> m_inFlight;
+    QSet<ImageCacheKey> m_revalidating; // Hits whose mtime check is queued or running
+};
+
+#endif // IMAGEDECODESERVICE_H
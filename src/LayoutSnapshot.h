@@ -0,0 +1,109 @@
+#ifndef LAYOUTSNAPSHOT_H
+#define LAYOUTSNAPSHOT_H
+
+#include <QSharedData>
+#include <QSharedDataPointer>
+#include <QString>
+#include <QRectF>
+#include <QPointF>
+#include <QColor>
+#include <QUuid>
+#include <QList>
+
+// Immutable, implicitly shared copies of the layout model.
+//
+// PageData/ZoneData/IconData stay the GUI thread's mutable model. Whenever it changes,
+// PageManager publishes a LayoutSnapshot built from these value types. Unchanged zones
+// reuse their previous ZoneSnapshot, so a new version shares everything but the edited parts.
+// Snapshots are only ever read through const accessors, so copies never detach and can be
+// handed to worker threads (serialising, indexing, thumbnailing, export) without locks.
+// DatabaseManager::savePages() writes the full save from one.
+
+struct IconSnapshot
+{
+    QUuid id;
+    QString filePath;
+    QPointF positionInZone;
+};
+
+struct IconStackSnapshot
+{
+    QUuid id;
+    QString title;
+    QPointF positionInZone;
+    QList<IconSnapshot> icons; // Members, in the stack's order
+};
+
+class ZoneSnapshotData : public QSharedData
+{
+public:
+    QUuid id;
+    QUuid pageId;
+    QString title;
+    QRectF geometry;
+    QColor backgroundColor;
+    int cornerRadius = 0;
+    QString backgroundImagePath;
+    bool blurBackgroundImage = false;
+    QList<IconSnapshot> icons;       // Loose icons
+    QList<IconStackSnapshot> stacks;
+};
+
+class ZoneSnapshot
+{
+public:
+    ZoneSnapshot() = default;
+    explicit ZoneSnapshot(ZoneSnapshotData* data) : d(data) {}
+
+    bool isNull() const { return !d; }
+    QUuid id() const { return d->id; }
+    QUuid pageId() const { return d->pageId; }
+    QString title() const { return d->title; }
+    QRectF geometry() const { return d->geometry; }
+    QColor backgroundColor() const { return d->backgroundColor; }
+    int cornerRadius() const { return d->cornerRadius; }
+    QString backgroundImagePath() const { return d->backgroundImagePath; }
+    bool blurBackgroundImage() const { return d->blurBackgroundImage; }
+    const QList<IconSnapshot>& icons() const { return d->icons; }
+    const QList<IconStackSnapshot>& stacks() const { return d->stacks; }
+
+private:
+    QSharedDataPointer<ZoneSnapshotData> d; // Const access only, so it never detaches
+};
+
+class PageSnapshotData : public QSharedData
+{
+public:
+    QUuid id;
+    QString name;
+    QString wallpaperPath;
+    QColor overlayColor;
+    QList<ZoneSnapshot> zones;
+};
+
+class PageSnapshot
+{
+public:
+    PageSnapshot() = default;
+    explicit PageSnapshot(PageSnapshotData* data) : d(data) {}
+
+    bool isNull() const { return !d; }
+    QUuid id() const { return d->id; }
+    QString name() const { return d->name; }
+    QString wallpaperPath() const { return d->wallpaperPath; }
+    QColor overlayColor() const { return d->overlayColor; }
+    const QList<ZoneSnapshot>& zones() const { return d->zones; }
+
+private:
+    QSharedDataPointer<PageSnapshotData> d;
+};
+
+// Root of one published layout version
+struct LayoutSnapshot
+{
+    quint64 version = 0; // Increases with every publish; 0 means nothing published yet
+    int activePageIndex = -1;
+    QList<PageSnapshot> pages;
+};
+
+#endif // LAYOUTSNAPSHOT_H
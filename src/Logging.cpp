@@ -0,0 +1,161 @@
+#include "Logging.h"
+#include <QFile>
+#include <QDir>
+#include <QStandardPaths>
+#include <QTextStream>
+#include <QDebug>
+#include <atomic>
+#include <csignal>
+#include <cstdio>
+#include <cstring>
+
+Q_LOGGING_CATEGORY(lcModel, "desktopoverlay.model", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcZone, "desktopoverlay.zone", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcIcon, "desktopoverlay.icon", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcFilter, "desktopoverlay.filter", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcDatabase, "desktopoverlay.db", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcImage, "desktopoverlay.image", QtWarningMsg)
+Q_LOGGING_CATEGORY(lcPage, "desktopoverlay.page", QtWarningMsg)
+
+namespace {
+
+constexpr int RingSlots = 2048;    // Power of two so the index wraps with a mask
+constexpr int SlotTextSize = 240;  // Longer lines are truncated
+
+// A slot's sequence is odd while it is being written and 2 * (index + 1) once complete.
+// Readers copy the text and accept it only if the sequence was even and unchanged around the copy.
+struct RingSlot
+{
+    std::atomic<quint64> sequence{0};
+    char text[SlotTextSize];
+};
+
+RingSlot s_ring[RingSlots];
+std::atomic<quint64> s_writeIndex{0};
+QtMessageHandler s_previousHandler = nullptr;
+char s_crashLogPath[1024] = {0}; // Filled at install time; the signal handler cannot allocate
+
+char typeLetter(QtMsgType type)
+{
+    switch (type) {
+    case QtDebugMsg: return 'D';
+    case QtInfoMsg: return 'I';
+    case QtWarningMsg: return 'W';
+    case QtCriticalMsg: return 'C';
+    case QtFatalMsg: return 'F';
+    }
+    return '?';
+}
+
+void appendToRing(QtMsgType type, const char* category, const QByteArray& message)
+{
+    const quint64 index = s_writeIndex.fetch_add(1, std::memory_order_relaxed);
+    RingSlot& slot = s_ring[index & (RingSlots - 1)];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    std::snprintf(slot.text, SlotTextSize, "%c %s: %s", typeLetter(type), category ? category : "default", message.constData());
+    slot.sequence.store(2 * (index + 1), std::memory_order_release);
+}
+
+// Returns false if the slot is empty, being written, or was overwritten during the copy
+bool readSlot(quint64 index, char* out)
+{
+    const RingSlot& slot = s_ring[index & (RingSlots - 1)];
+    const quint64 before = slot.sequence.load(std::memory_order_acquire);
+    if (before != 2 * (index + 1)) {
+        return false;
+    }
+    std::memcpy(out, slot.text, SlotTextSize);
+    std::atomic_thread_fence(std::memory_order_acquire);
+    out[SlotTextSize - 1] = '\0';
+    return slot.sequence.load(std::memory_order_relaxed) == before;
+}
+
+void messageHandler(QtMsgType type, const QMessageLogContext& context, const QString& message)
+{
+    appendToRing(type, context.category, message.toUtf8());
+
+    // Only messages whose category is enabled get here, so debug and info reach the console just as
+    // they did before the ring: silence them with rules such as QT_LOGGING_RULES="default.debug=false".
+    if (s_previousHandler) {
+        s_previousHandler(type, context, message);
+    } else {
+        std::fprintf(stderr, "%s\n", qPrintable(qFormatLogMessage(type, context, message)));
+    }
+}
+
+// Best effort: stdio is not async-signal-safe, but the process is going down either way
+void crashHandler(int signalNumber)
+{
+    std::signal(signalNumber, SIG_DFL);
+    if (s_crashLogPath[0] != '\0') {
+        if (std::FILE* file = std::fopen(s_crashLogPath, "w")) {
+            std::fprintf(file, "Fatal signal %d. Last log lines:\n", signalNumber);
+            const quint64 end = s_writeIndex.load(std::memory_order_acquire);
+            const quint64 begin = end > RingSlots ? end - RingSlots : 0;
+            char line[SlotTextSize];
+            for (quint64 i = begin; i < end; ++i) {
+                if (readSlot(i, line)) {
+                    std::fputs(line, file);
+                    std::fputc('\n', file);
+                }
+            }
+            std::fclose(file);
+        }
+    }
+    std::raise(signalNumber);
+}
+
+} // namespace
+
+namespace LogRing
+{
+
+void install()
+{
+    const QString dir = QStandardPaths::writableLocation(QStandardPaths::AppDataLocation);
+    QDir().mkpath(dir);
+    const QByteArray path = QDir::toNativeSeparators(dir + "/crash_log.txt").toLocal8Bit();
+    qstrncpy(s_crashLogPath, path.constData(), sizeof(s_crashLogPath));
+
+    s_previousHandler = qInstallMessageHandler(messageHandler);
+    std::signal(SIGSEGV, crashHandler);
+    std::signal(SIGABRT, crashHandler);
+}
+
+QStringList lines()
+{
+    QStringList result;
+    const quint64 end = s_writeIndex.load(std::memory_order_acquire);
+    const quint64 begin = end > RingSlots ? end - RingSlots : 0;
+    char line[SlotTextSize];
+    for (quint64 i = begin; i < end; ++i) {
+        if (readSlot(i, line)) {
+            result.append(QString::fromUtf8(line));
+        }
+    }
+    return result;
+}
+
+bool dumpToFile(const QString& filePath)
+{
+    QFile file(filePath);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate | QIODevice::Text)) {
+        qWarning() << "LogRing: Could not open" << filePath << "for writing:" << file.errorString();
+        return false;
+    }
+    QTextStream out(&file);
+    const QStringList allLines = lines();
+    for (const QString& line : allLines) {
+        out << line << '\n';
+    }
+    return true;
+}
+
+QString crashLogPath()
+{
+    return QString::fromLocal8Bit(s_crashLogPath);
+}
+
+} // namespace LogRing
@@ -0,0 +1,31 @@
+#ifndef LOGGING_H
+#define LOGGING_H
+
+#include <QLoggingCategory>
+#include <QString>
+#include <QStringList>
+
+// Logging categories for per-object and hot-path messages. Debug output is off by default,
+// so a disabled qCDebug() costs one flag check and never formats its arguments.
+// Enable with e.g. QT_LOGGING_RULES="desktopoverlay.zone.debug=true".
+Q_DECLARE_LOGGING_CATEGORY(lcModel)    // desktopoverlay.model  - PageData lifetime and ownership
+Q_DECLARE_LOGGING_CATEGORY(lcZone)     // desktopoverlay.zone   - ZoneData lifetime and icon membership
+Q_DECLARE_LOGGING_CATEGORY(lcIcon)     // desktopoverlay.icon   - IconWidget lifetime
+Q_DECLARE_LOGGING_CATEGORY(lcFilter)   // desktopoverlay.filter - Icon search
+Q_DECLARE_LOGGING_CATEGORY(lcDatabase) // desktopoverlay.db     - Load and save progress
+Q_DECLARE_LOGGING_CATEGORY(lcImage)    // desktopoverlay.image  - Background decoding and image caching
+Q_DECLARE_LOGGING_CATEGORY(lcPage)     // desktopoverlay.page   - Page tabs and their wallpapers
+
+// In-memory sink for every message that passes its category filter. Each message is then handed
+// on to the previous handler, so the console output is unchanged.
+// Writers claim a slot with one atomic increment and never block each other;
+// the oldest lines are overwritten once the ring is full.
+namespace LogRing
+{
+    void install();                           // Installs the message handler and the crash handlers
+    QStringList lines();                      // Completed lines, oldest first
+    bool dumpToFile(const QString& filePath); // Returns false if the file cannot be written
+    QString crashLogPath();                   // Where the ring is written on SIGSEGV/SIGABRT
+}
+
+#endif // LOGGING_H
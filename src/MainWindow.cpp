@@ -2,7 +2,16 @@
 #include "PageManager.h"
 #include "PageData.h" // Required for PageData type
 #include "PageTabContentWidget.h" // Include the new widget
+#include "ZoneWidget.h"           // For handing icon widgets between zones
+#include "IconWidget.h"
 #include "DatabaseManager.h"      // Include DatabaseManager
+#include "Logging.h"              // For dumping the log ring
+#include "PerfMonitor.h"          // For frame timings
+#include "PerformanceHud.h"
+#include "PageRenderCache.h"      // Renders that feed the page thumbnails
+#include "PageThumbnailCache.h"
+#include "PageOverview.h"
+#include <QElapsedTimer>
 #include <QPainter>
 #include <QMouseEvent>
 #include <QCloseEvent>           // For closeEvent
@@ -20,6 +29,7 @@
 #include <QSettings>    // For QSettings (used for widget persistence)
 #include <QLineEdit>    // For icon search bar
 #include <QFileDialog>  // For wallpaper selection
+#include <QDir>
 
 // Include headers for new widgets/windows
 #include "WidgetHostWindow.h"
@@ -32,11 +42,12 @@
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent),
       m_pageManager(new PageManager(this)),
-      m_dbManager(new DatabaseManager("DesktopOverlay.sqlite", this)) // Create DB Manager
+      m_dbManager(new DatabaseManager("DesktopOverlay.sqlite", this)), // Create DB Manager
+      m_thumbnailCache(new PageThumbnailCache(m_dbManager, this)),
+      m_performanceHud(nullptr),
+      m_pageOverview(nullptr)
 {
-    // It's important to set OrganizationName and ApplicationName for QSettings
-    QCoreApplication::setOrganizationName("MyCompany"); // Replace as needed
-    QCoreApplication::setApplicationName("DesktopOverlay");
+    // OrganizationName and ApplicationName are set in main() before the log ring is installed
 
     setupUI();
     setupPageControls();
@@ -53,6 +64,16 @@ MainWindow::MainWindow(QWidget *parent)
     connect(m_pageManager, &PageManager::zoneAddedToPage, this, &MainWindow::handleZoneAddedToPage);
     connect(m_pageManager, &PageManager::zoneRemovedFromPage, this, &MainWindow::handleZoneRemovedFromPage);
     connect(m_pageManager, &PageManager::zoneDataChanged, this, &MainWindow::handleZoneDataChanged);
+    connect(m_pageManager, &PageManager::iconsMoved, this, &MainWindow::handleIconsMoved);
+    connect(m_pageManager, &PageManager::iconsAdded, this, &MainWindow::handleIconsAdded);
+    connect(m_pageManager, &PageManager::iconsRemoved, this, &MainWindow::handleIconsRemoved);
+    connect(m_pageManager, &PageManager::zoneGeometryChanged, this, &MainWindow::handleZoneGeometryChanged);
+    connect(m_pageManager, &PageManager::zoneStyleChanged, this, &MainWindow::handleZoneStyleChanged);
+    connect(m_pageManager, &PageManager::zoneTitleChanged, this, &MainWindow::handleZoneTitleChanged);
+    connect(m_pageManager, &PageManager::zoneStacksChanged, this, &MainWindow::handleZoneStacksChanged);
+    connect(m_pageManager, &PageManager::iconsTransferred, this, &MainWindow::handleIconsTransferred);
+    // Each committed batch is written to the database as one transaction
+    connect(m_pageManager, &PageManager::changesCommitted, m_dbManager, &DatabaseManager::saveChanges);
     // pageOrderChanged from PageManager doesn't need a slot if DB saves the current order from m_pages directly.
 
     // Connect QTabWidget/QTabBar signals for UI interactions
@@ -188,11 +209,40 @@ void MainWindow::setupMenuBar()
     QAction *addTodoAction = widgetsMenu->addAction(tr("Show To-Do &List"));
     connect(addTodoAction, &QAction::triggered, this, &MainWindow::showTodoWidget);
 
+    QAction *overviewAction = viewMenu->addAction(tr("Page &Overview"));
+    connect(overviewAction, &QAction::triggered, this, &MainWindow::showPageOverview);
+    viewMenu->addSeparator();
+
+    // Zones above ZoneWidget's threshold always paint their icons; this extends it to every zone.
+    // Read before loadSettings() creates the zones, so they start in the right mode.
+    QAction *paintIconsAction = viewMenu->addAction(tr("&Paint Icons Directly"));
+    paintIconsAction->setCheckable(true);
+    const bool paintIconsAlways = QSettings().value("view/paintIconsAlways", false).toBool();
+    paintIconsAction->setChecked(paintIconsAlways);
+    ZoneWidget::setPaintIconsAlways(paintIconsAlways);
+    connect(paintIconsAction, &QAction::toggled, this, &MainWindow::setPaintIconsAlways);
+
+    // Unchecked, zones resize live (throttled to the display refresh rate) instead of showing a frame
+    QAction *outlineResizeAction = viewMenu->addAction(tr("&Outline Resize"));
+    outlineResizeAction->setCheckable(true);
+    const bool outlineResize = QSettings().value("view/outlineResize", true).toBool();
+    outlineResizeAction->setChecked(outlineResize);
+    ZoneWidget::setOutlineResize(outlineResize);
+    connect(outlineResizeAction, &QAction::toggled, this, &MainWindow::setOutlineResize);
+
+    viewMenu->addSeparator();
+    QAction *hudAction = viewMenu->addAction(tr("Performance &HUD"));
+    hudAction->setCheckable(true);
+    connect(hudAction, &QAction::toggled, this, &MainWindow::setPerformanceHudVisible);
+
     settingsMenu->addSeparator();
     QAction *exportAction = settingsMenu->addAction(tr("&Export Settings..."));
     connect(exportAction, &QAction::triggered, this, &MainWindow::exportSettings);
     QAction *importAction = settingsMenu->addAction(tr("&Import Settings..."));
     connect(importAction, &QAction::triggered, this, &MainWindow::importSettings);
+    settingsMenu->addSeparator();
+    QAction *saveLogAction = settingsMenu->addAction(tr("Save Diagnostic &Log..."));
+    connect(saveLogAction, &QAction::triggered, this, &MainWindow::saveDiagnosticLog);
 
 
     // Help Menu (example)
@@ -236,6 +286,15 @@ void MainWindow::onPageAddedToManager(PageData* page, int index)
     // Each tab will hold an instance of PageTabContentWidget.
     // Pass PageData and PageManager to PageTabContentWidget
     PageTabContentWidget* pageContentWidget = new PageTabContentWidget(page, m_pageManager, m_tabWidget);
+    m_tabContentByPageId.insert(page->id(), pageContentWidget);
+    connect(pageContentWidget, &PageTabContentWidget::iconDroppedOutsideZones, this, &MainWindow::handleIconDroppedOutsideZones);
+    // Every page render refreshes the same rects of the page's thumbnail
+    const QUuid pageId = page->id();
+    PageRenderCache* renderCache = pageContentWidget->renderCache();
+    connect(renderCache, &PageRenderCache::rendered, m_thumbnailCache, [this, pageId, renderCache, pageContentWidget](const QRegion& region) {
+        // Checked after the render, which itself starts the lookups of icons painted for the first time
+        m_thumbnailCache->updateFromRender(pageId, renderCache->pixmap(), region, !pageContentWidget->hasPendingContent());
+    });
 
     int tabIndex = m_tabWidget->addTab(pageContentWidget, page->name());
 
@@ -249,13 +308,12 @@ void MainWindow::onPageAddedToManager(PageData* page, int index)
 void MainWindow::onPageRemovedFromManager(QUuid pageId, int managerIndex)
 {
     Q_UNUSED(managerIndex); // managerIndex might not match tabIndex if tabs were reordered
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageId() == pageId) {
-            m_tabWidget->removeTab(i);
-            qDebug() << "Removed tab for page ID:" << pageId;
-            break;
-        }
+    m_thumbnailCache->removePage(pageId);
+    PageTabContentWidget* tabContent = m_tabContentByPageId.take(pageId);
+    if (tabContent) {
+        m_tabWidget->removeTab(m_tabWidget->indexOf(tabContent));
+        delete tabContent; // removeTab doesn't delete; do it now, while its PageData (deleted after this signal) is still valid
+        qDebug() << "Removed tab for page ID:" << pageId;
     }
 }
 
@@ -274,14 +332,9 @@ void MainWindow::onActivePageChanged(PageData* page, int index)
     if (page) {
         qDebug() << "Active page changed in manager:" << page->name() << "at index" << index;
         // Find the tab corresponding to this page and set it as current
-        for (int i = 0; i < m_tabWidget->count(); ++i) {
-            PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-            if (tabContent && tabContent->pageId() == page->id()) {
-                if (m_tabWidget->currentIndex() != i) {
-                    m_tabWidget->setCurrentIndex(i); // This will trigger handleCurrentTabChanged
-                }
-                break;
-            }
+        PageTabContentWidget* tabContent = tabContentForPage(page->id());
+        if (tabContent && m_tabWidget->currentWidget() != tabContent) {
+            m_tabWidget->setCurrentWidget(tabContent); // This will trigger handleCurrentTabChanged
         }
     } else {
         qDebug() << "No active page in manager.";
@@ -330,6 +383,65 @@ void MainWindow::handleTabCloseRequested(int index)
 
 
 // --- Backup and Restore ---
+void MainWindow::saveDiagnosticLog()
+{
+    QString filePath = QFileDialog::getSaveFileName(this, tr("Save Diagnostic Log"),
+                                                    QDir::homePath() + "/DesktopOverlay_log.txt",
+                                                    tr("Text Files (*.txt)"));
+    if (filePath.isEmpty()) {
+        return;
+    }
+    if (!LogRing::dumpToFile(filePath)) {
+        QMessageBox::warning(this, tr("Save Failed"), tr("Could not write the log to:\n%1").arg(filePath));
+    }
+}
+
+void MainWindow::setOutlineResize(bool outline)
+{
+    QSettings().setValue("view/outlineResize", outline);
+    ZoneWidget::setOutlineResize(outline); // Read at every resize step; nothing to refresh
+}
+
+void MainWindow::setPerformanceHudVisible(bool visible)
+{
+    if (!m_performanceHud) {
+        if (!visible) return;
+        m_performanceHud = new PerformanceHud(this);
+    }
+    m_performanceHud->setVisible(visible); // Timings are only recorded while it is shown
+}
+
+void MainWindow::showPageOverview()
+{
+    if (!m_pageOverview) {
+        m_pageOverview = new PageOverview(m_thumbnailCache, m_tabWidget);
+        connect(m_pageOverview, &PageOverview::pageChosen, this, [this](const QUuid& pageId) {
+            if (PageTabContentWidget* tabContent = tabContentForPage(pageId)) {
+                m_tabWidget->setCurrentWidget(tabContent); // Shows its cached render first, like any tab switch
+            }
+        });
+    }
+    QList<PageOverview::Entry> pages;
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        if (PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i))) {
+            pages.append({tabContent->pageId(), m_tabWidget->tabText(i)}); // Tab order
+        }
+    }
+    PageTabContentWidget* current = qobject_cast<PageTabContentWidget*>(m_tabWidget->currentWidget());
+    m_pageOverview->open(pages, current ? current->pageId() : QUuid());
+}
+
+void MainWindow::setPaintIconsAlways(bool always)
+{
+    QSettings().setValue("view/paintIconsAlways", always);
+    ZoneWidget::setPaintIconsAlways(always);
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        if (PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i))) {
+            tabContent->refreshIconRenderMode();
+        }
+    }
+}
+
 void MainWindow::exportSettings() {
     // 1. Ensure current settings are saved to their respective files
     saveSettings(); // This saves SQLite DB and QSettings for hosted widgets
@@ -459,6 +571,13 @@ void MainWindow::importSettings() {
 // --- Settings Load/Save ---
 void MainWindow::handleCurrentTabChanged(int index)
 {
+    // Keep the neighbouring tabs rendered offscreen, so stepping to them is instant
+    for (int i = 0; i < m_tabWidget->count(); ++i) {
+        if (PageTabContentWidget* page = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i))) {
+            page->renderCache()->setPrerender(index >= 0 && qAbs(i - index) == 1);
+        }
+    }
+
     if (index >= 0 && index < m_tabWidget->count()) {
         PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(index));
         if (tabContent) {
@@ -475,6 +594,19 @@ void MainWindow::handleCurrentTabChanged(int index)
 }
 
 
+bool MainWindow::event(QEvent *event)
+{
+    if (event->type() == QEvent::UpdateRequest && PerfMonitor::isEnabled()) {
+        // One UpdateRequest paints every dirty widget of the window and flushes it: one frame
+        QElapsedTimer frameTimer;
+        frameTimer.start();
+        const bool handled = QMainWindow::event(event);
+        PerfMonitor::instance()->recordFrame(frameTimer.nsecsElapsed());
+        return handled;
+    }
+    return QMainWindow::event(event);
+}
+
 void MainWindow::paintEvent(QPaintEvent *event)
 {
     Q_UNUSED(event);
@@ -532,12 +664,9 @@ void MainWindow::handleZoneAddedToPage(PageData* page, ZoneData* zoneData)
     if (!page || !zoneData) return;
 
     // Find the PageTabContentWidget for this page
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageId() == page->id()) {
-            tabContent->handleZoneAdded(page, zoneData);
-            return;
-        }
+    if (PageTabContentWidget* tabContent = tabContentForPage(page->id())) {
+        tabContent->handleZoneAdded(page, zoneData);
+        return;
     }
     qWarning() << "MainWindow: Could not find PageTabContentWidget for page" << page->id() << "to add zone" << zoneData->id();
 }
@@ -546,12 +675,9 @@ void MainWindow::handleZoneRemovedFromPage(PageData* page, QUuid zoneId)
 {
     if (!page) return;
 
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageId() == page->id()) {
-            tabContent->handleZoneRemoved(page, zoneId);
-            return;
-        }
+    if (PageTabContentWidget* tabContent = tabContentForPage(page->id())) {
+        tabContent->handleZoneRemoved(page, zoneId);
+        return;
     }
     qWarning() << "MainWindow: Could not find PageTabContentWidget for page" << page->id() << "to remove zone" << zoneId;
 }
@@ -560,26 +686,107 @@ void MainWindow::handleZoneDataChanged(ZoneData* zone)
 {
     if (!zone) return;
 
-    // This signal is less specific about which page it's for,
-    // so we might need to iterate all PageTabContentWidgets or PageManager needs to provide page context.
-    // For now, let's assume PageManager might emit this for a zone on any page.
-    // A better approach: ZoneDataChanged signal from PageManager should include PageData*
+    // ZoneData knows its owning page, so this is a single hash lookup
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleZoneDataChanged(zone);
+    }
+     //qDebug() << "MainWindow: ZoneDataChanged for zone" << zone->id();
+}
 
-    // Find which page this zone belongs to by asking PageManager (if possible) or iterating.
-    // For now, we assume the ZoneWidget itself will update if its ZoneData pointer is the same.
-    // This is simpler if PageTabContentWidget receives this signal directly for its zones.
-    // Let's refine this: The signal will be received by PageTabContentWidget directly if it connects.
-    // MainWindow will forward it to the *active* page's content for now, or all.
+PageTabContentWidget* MainWindow::tabContentForPage(const QUuid& pageId) const
+{
+    return m_tabContentByPageId.value(pageId, nullptr);
+}
 
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageData() && tabContent->pageData()->zoneById(zone->id())) {
-            tabContent->handleZoneDataChanged(zone);
-            // If a zone could be on multiple pages (not current design), this would need to call all relevant.
-            // return; // Found and handled
+PageTabContentWidget* MainWindow::tabContentForZone(ZoneData* zone) const
+{
+    if (!zone) return nullptr;
+    return tabContentForPage(zone->pageId());
+}
+
+void MainWindow::handleIconsMoved(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleIconsMoved(zone, iconIds);
+    }
+}
+
+void MainWindow::handleIconsAdded(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleIconsAdded(zone, iconIds);
+    }
+}
+
+void MainWindow::handleIconsRemoved(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleIconsRemoved(zone, iconIds);
+    }
+}
+
+void MainWindow::handleZoneGeometryChanged(ZoneData* zone)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleZoneGeometryChanged(zone);
+    }
+}
+
+void MainWindow::handleZoneStyleChanged(ZoneData* zone)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleZoneStyleChanged(zone);
+    }
+}
+
+void MainWindow::handleZoneTitleChanged(ZoneData* zone)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleZoneTitleChanged(zone);
+    }
+}
+
+void MainWindow::handleZoneStacksChanged(ZoneData* zone)
+{
+    if (PageTabContentWidget* tabContent = tabContentForZone(zone)) {
+        tabContent->handleZoneStacksChanged(zone);
+    }
+}
+
+void MainWindow::handleIconsTransferred(ZoneData* fromZone, ZoneData* toZone, const QList<QUuid>& iconIds)
+{
+    // Both sides may be on different tabs; the widgets move between them instead of being rebuilt
+    PageTabContentWidget* fromTab = tabContentForZone(fromZone);
+    PageTabContentWidget* toTab = tabContentForZone(toZone);
+    ZoneWidget* fromZoneWidget = fromTab ? fromTab->findZoneWidget(fromZone->id()) : nullptr;
+    ZoneWidget* toZoneWidget = toTab ? toTab->findZoneWidget(toZone->id()) : nullptr;
+
+    for (const QUuid& iconId : iconIds) {
+        IconWidget* iconWidget = fromZoneWidget ? fromZoneWidget->releaseIconWidget(iconId) : nullptr;
+        if (toZoneWidget) {
+            toZoneWidget->adoptIconWidget(toZone->findIcon(iconId), iconWidget);
+        } else if (iconWidget) {
+            iconWidget->detachData();
+            iconWidget->hide();
+            iconWidget->deleteLater();
         }
     }
-     //qDebug() << "MainWindow: ZoneDataChanged for zone" << zone->id();
+}
+
+void MainWindow::handleIconDroppedOutsideZones(ZoneData* fromZone, const QUuid& iconId, const QPoint& globalPos)
+{
+    QTabBar* tabBar = m_tabWidget->tabBar();
+    int tabIndex = tabBar->tabAt(tabBar->mapFromGlobal(globalPos));
+    if (tabIndex < 0) return; // Not over a page tab; the icon goes back home
+
+    PageTabContentWidget* targetTab = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(tabIndex));
+    if (!targetTab || !targetTab->pageData() || targetTab->pageId() == fromZone->pageId()) return;
+    if (targetTab->pageData()->zones().isEmpty()) {
+        qCDebug(lcPage) << "Icon dropped on page" << targetTab->pageData()->name() << "which has no zones; ignoring.";
+        return;
+    }
+    ZoneData* targetZone = targetTab->pageData()->zones().first();
+    m_pageManager->moveIcons(fromZone, targetZone, {iconId}, {QPointF(16, 32)}); // Top-left below the title bar
 }
 
 
@@ -619,6 +826,7 @@ void MainWindow::loadSettings()
     // For clarity, ensure applyCurrentTheme updates menu checks.
 
     if (m_dbManager->openDatabase()) {
+        m_thumbnailCache->load(); // Before the pages render fresh ones
         if (!m_dbManager->loadPages(m_pageManager)) {
             qWarning() << "MainWindow: Failed to load pages from database. Starting with a default page.";
             m_pageManager->clearAllPages();
@@ -928,12 +1136,9 @@ void MainWindow::clearPageOverlayColor(PageData* pageData) {
 
 void MainWindow::handlePagePropertiesChanged(PageData* pageData) {
     if (!pageData || !m_tabWidget) return;
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageId() == pageData->id()) {
-            tabContent->update(); // Trigger a repaint of the page content area
-            return;
-        }
+    if (PageTabContentWidget* tabContent = tabContentForPage(pageData->id())) {
+        tabContent->invalidateRender(); // Name, wallpaper or overlay: the page may be hidden
+        tabContent->update(); // Trigger a repaint of the page content area
     }
 }
 
@@ -943,7 +1148,8 @@ void MainWindow::saveSettings()
 {
     // Save Page/Zone/Icon structure to SQLite
     if (m_dbManager->openDatabase()) {
-        if (!m_dbManager->savePages(m_pageManager->pages())) {
+        m_thumbnailCache->flush(); // savePages() then drops the thumbnails of removed pages
+        if (!m_dbManager->savePages(*m_pageManager->snapshot())) { // The latest published layout version
             qWarning() << "MainWindow: Failed to save page structure to database.";
         } else {
             qDebug() << "MainWindow: Page structure saved successfully to database.";
@@ -985,13 +1191,12 @@ void MainWindow::closeEvent(QCloseEvent *event)
 void MainWindow::handlePageNameChanged(PageData* page) {
     if (!page || !m_tabWidget) return;
 
-    for (int i = 0; i < m_tabWidget->count(); ++i) {
-        PageTabContentWidget* tabContent = qobject_cast<PageTabContentWidget*>(m_tabWidget->widget(i));
-        if (tabContent && tabContent->pageId() == page->id()) {
-            m_tabWidget->setTabText(i, page->name());
-            qDebug() << "Tab text updated for page ID" << page->id() << "to" << page->name();
-            return;
-        }
+    PageTabContentWidget* tabContent = tabContentForPage(page->id());
+    int tabIndex = tabContent ? m_tabWidget->indexOf(tabContent) : -1;
+    if (tabIndex != -1) {
+        m_tabWidget->setTabText(tabIndex, page->name());
+        qDebug() << "Tab text updated for page ID" << page->id() << "to" << page->name();
+        return;
     }
     qWarning() << "Could not find tab to update name for page ID" << page->id();
 }
@@ -9,6 +9,7 @@
 #include <QPushButton>
 #include <QVBoxLayout>
 #include <QHBoxLayout>
+#include <QHash>
 
 class PageManager; // Forward declaration
 class PageData;    // Forward declaration for PageData
@@ -24,6 +25,10 @@ class DraggableToolbar; // Forward declaration
 class ClockWidget;      // Forward declaration
 class QuickAccessPanel; // Forward declaration
 class TodoWidget;       // Forward declaration
+class PageTabContentWidget; // Forward declaration
+class PerformanceHud;   // Forward declaration
+class PageThumbnailCache; // Forward declaration
+class PageOverview;     // Forward declaration
 
 class MainWindow : public QMainWindow
 {
@@ -45,6 +50,15 @@ private slots:
     void handleZoneAddedToPage(PageData* page, ZoneData* zoneData);
     void handleZoneRemovedFromPage(PageData* page, QUuid zoneId);
     void handleZoneDataChanged(ZoneData* zone);
+    void handleIconsMoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void handleIconsAdded(ZoneData* zone, const QList<QUuid>& iconIds);
+    void handleIconsRemoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void handleZoneGeometryChanged(ZoneData* zone);
+    void handleZoneStyleChanged(ZoneData* zone);
+    void handleZoneTitleChanged(ZoneData* zone);
+    void handleZoneStacksChanged(ZoneData* zone);
+    void handleIconsTransferred(ZoneData* fromZone, ZoneData* toZone, const QList<QUuid>& iconIds);
+    void handleIconDroppedOutsideZones(ZoneData* fromZone, const QUuid& iconId, const QPoint& globalPos); // Page tab drops
     void handlePageNameChanged(PageData* page); // Slot for PageManager::pageNameChanged
     void handleTabMoved(int fromIndex, int toIndex); // Slot for QTabBar::tabMoved
 
@@ -55,6 +69,7 @@ private slots:
 
 
 protected:
+    bool event(QEvent *event) override; // Times each frame for the performance HUD
     void paintEvent(QPaintEvent *event) override;
     void closeEvent(QCloseEvent *event) override; // For saving on close
     // void mousePressEvent(QMouseEvent *event) override; // Will be handled by child widgets or specific areas
@@ -68,6 +83,8 @@ private:
     void loadSettings();
     void saveSettings();
     void applyCurrentTheme(); // Helper to apply loaded theme
+    PageTabContentWidget* tabContentForPage(const QUuid& pageId) const; // O(1) via m_tabContentByPageId
+    PageTabContentWidget* tabContentForZone(ZoneData* zone) const; // Tab showing the page that owns zone
 
     // Theme actions
     void selectLightTheme();
@@ -91,12 +108,18 @@ private:
     // Backup/Restore
     void exportSettings();
     void importSettings();
+    void saveDiagnosticLog(); // Writes the in-memory log ring to a file
+    void setPaintIconsAlways(bool always); // View > Paint Icons Directly
+    void setOutlineResize(bool outline);   // View > Outline Resize
+    void setPerformanceHudVisible(bool visible); // View > Performance HUD
+    void showPageOverview(); // View > Page Overview
 
 
     QPoint m_dragPosition; // Keep for now, might be useful for dragging toolbar/main window parts
 
     PageManager* m_pageManager;
     DatabaseManager* m_dbManager; // Database manager instance
+    PageThumbnailCache* m_thumbnailCache; // Page overview pictures, fed by each page's cached renders
     QTabWidget* m_tabWidget;
     QPushButton* m_addPageButton;
     QPushButton* m_addZoneButton; // Button to add a new zone
@@ -105,6 +128,7 @@ private:
     QVBoxLayout* m_mainLayout; // Main vertical layout
     QHBoxLayout* m_controlsLayout; // Layout for controls like add page button
     QWidget* m_pageControlsWidget; // Widget to hold page controls
+    QHash<QUuid, PageTabContentWidget*> m_tabContentByPageId; // Routes page/zone notifications without scanning tabs
 
     // Theme menu actions
     QAction* m_lightThemeAction;
@@ -113,6 +137,9 @@ private:
 
     // Hosted Widgets
     QList<WidgetHostWindow*> m_hostedWidgets;
+
+    PerformanceHud* m_performanceHud; // Created when first shown
+    PageOverview* m_pageOverview;     // Created when first opened
 };
 
 #endif // MAINWINDOW_H
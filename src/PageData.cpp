@@ -1,18 +1,19 @@
 #include "PageData.h"
 #include "ZoneData.h" // Required for ZoneData definition
 #include <QDebug>
+#include "Logging.h"
 #include <QColor> // For Qt::transparent
 
 PageData::PageData(const QString& name)
     : m_id(QUuid::createUuid()), m_name(name), m_overlayColor(Qt::transparent) // Initialize new members
 {
-    qDebug() << "PageData created (new UUID):" << m_id << name;
+    qCDebug(lcModel) << "PageData created (new UUID):" << m_id << name;
 }
 
 PageData::PageData(QUuid id, const QString& name)
     : m_id(id), m_name(name), m_overlayColor(Qt::transparent) // Initialize new members
 {
-    qDebug() << "PageData created (existing UUID):" << m_id << name;
+    qCDebug(lcModel) << "PageData created (existing UUID):" << m_id << name;
 }
 
 // Constructor for loading from DB will be updated in DatabaseManager to pass these
@@ -20,7 +21,7 @@ PageData::PageData(QUuid id, const QString& name)
 
 PageData::~PageData()
 {
-    qDebug() << "PageData destroyed:" << m_id << m_name << "Clearing" << m_zones.count() << "zones.";
+    qCDebug(lcModel) << "PageData destroyed:" << m_id << m_name << "Clearing" << m_zones.count() << "zones.";
     // Delete all ZoneData objects this page owns
     qDeleteAll(m_zones);
     m_zones.clear();
@@ -51,7 +52,9 @@ void PageData::addZone(ZoneData* zone)
 {
     if (zone && !m_zones.contains(zone)) {
         m_zones.append(zone);
-        qDebug() << "Zone" << zone->id() << "added to page" << m_id;
+        zone->m_pageId = m_id;
+        zone->invalidateSnapshot();
+        qCDebug(lcModel) << "Zone" << zone->id() << "added to page" << m_id;
     }
 }
 
@@ -60,7 +63,9 @@ bool PageData::removeZone(ZoneData* zone)
     if (!zone) return false;
     bool removed = m_zones.removeOne(zone);
     if (removed) {
-        qDebug() << "Zone" << zone->id() << "removed from page" << m_id << "(pointer match)";
+        zone->m_pageId = QUuid();
+        zone->invalidateSnapshot();
+        qCDebug(lcModel) << "Zone" << zone->id() << "removed from page" << m_id << "(pointer match)";
         // Caller (PageManager) is responsible for deleting the zone object itself
     }
     return removed;
@@ -71,8 +76,10 @@ bool PageData::removeZoneById(const QUuid& id)
     for (int i = 0; i < m_zones.size(); ++i) {
         if (m_zones.at(i) && m_zones.at(i)->id() == id) {
             ZoneData* zoneToRemove = m_zones.takeAt(i);
+            zoneToRemove->m_pageId = QUuid();
+            zoneToRemove->invalidateSnapshot();
             // Caller (PageManager) is responsible for deleting zoneToRemove.
-            qDebug() << "Zone" << id << "removed from page" << m_id << "(ID match)";
+            qCDebug(lcModel) << "Zone" << id << "removed from page" << m_id << "(ID match)";
             return true;
         }
     }
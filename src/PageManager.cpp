@@ -1,9 +1,12 @@
 #include "PageManager.h"
 #include "ZoneData.h" // For ZoneData type
+#include "IconData.h"
+#include "Logging.h"
 #include <QDebug>
 
 PageManager::PageManager(QObject *parent)
-    : QObject(parent), m_activePageIndex(-1)
+    : QObject(parent), m_activePageIndex(-1), m_batchDepth(0),
+      m_snapshot(std::make_shared<const LayoutSnapshot>()), m_snapshotVersion(0), m_snapshotDirty(false)
 {
 }
 
@@ -42,6 +45,7 @@ PageData* PageManager::addPage(const QString& name)
     m_pages.append(newPage);
     int newIndex = m_pages.size() - 1;
     emit pageAdded(newPage, newIndex);
+    schedulePublish();
 
     if (m_activePageIndex == -1 && !m_pages.isEmpty()) {
         setActivePageIndex(0); // Activate the first page if none was active
@@ -54,6 +58,9 @@ bool PageManager::removePage(int index)
     if (index >= 0 && index < m_pages.size()) {
         PageData* pageToRemove = m_pages.takeAt(index);
         QUuid removedId = pageToRemove->id();
+        for (ZoneData* zone : pageToRemove->zones()) {
+            discardPendingChanges(zone);
+        }
 
         // Clean up zones associated with this page
         // ZoneData destructor now handles deleting its IconData, PageData destructor handles its ZoneData.
@@ -63,8 +70,9 @@ bool PageManager::removePage(int index)
         // }
         // pageToRemove->m_zones.clear(); // No longer needed if PageData destructor handles it (which it should)
 
-        delete pageToRemove; // Clean up page memory. Its destructor will handle its contents.
+        // Notify before deleting so receivers can tear down widgets that still point at this page's data
         emit pageRemoved(removedId, index);
+        delete pageToRemove; // Clean up page memory. Its destructor will handle its contents.
 
         if (m_pages.isEmpty()) {
             m_activePageIndex = -1;
@@ -76,6 +84,7 @@ bool PageManager::removePage(int index)
                 m_activePageIndex--;
             }
         }
+        schedulePublish();
         return true;
     }
     return false;
@@ -108,11 +117,13 @@ void PageManager::setActivePageIndex(int index)
         if (m_activePageIndex != index) {
             m_activePageIndex = index;
             emit activePageChanged(activePage(), m_activePageIndex);
+            schedulePublish();
         }
     } else if (m_pages.isEmpty() && index != -1) {
         if (m_activePageIndex != -1) {
              m_activePageIndex = -1;
              emit activePageChanged(nullptr, -1);
+             schedulePublish();
         }
     } else if (index != -1) {
         qWarning() << "PageManager::setActivePageIndex: Invalid index" << index << "for page count" << m_pages.size();
@@ -142,6 +153,7 @@ ZoneData* PageManager::addZoneToActivePage(const QString& title, const QRectF& g
     ZoneData* newZone = new ZoneData(title, geometry, backgroundColor);
     currentPage->addZone(newZone);
     emit zoneAddedToPage(currentPage, newZone);
+    schedulePublish();
     return newZone;
 }
 
@@ -155,6 +167,7 @@ ZoneData* PageManager::addZoneToPage(const QUuid& pageId, const QString& title,
     ZoneData* newZone = new ZoneData(title, geometry, backgroundColor);
     targetPage->addZone(newZone);
     emit zoneAddedToPage(targetPage, newZone);
+    schedulePublish();
     return newZone;
 }
 
@@ -184,8 +197,10 @@ bool PageManager::removeZoneFromPage(const QUuid& pageId, const QUuid& zoneId)
         // Current PageData::removeZoneById does NOT delete the ZoneData pointer, just removes from list.
         // So PageManager MUST delete zoneToRemove.
         if (targetPage->removeZoneById(zoneId)) { // This just removes from list
+            discardPendingChanges(zoneToRemove);
             emit zoneRemovedFromPage(targetPage, zoneId);
             delete zoneToRemove; // PageManager deletes the ZoneData object, which in turn deletes its IconData
+            schedulePublish();
             return true;
         }
     }
@@ -197,8 +212,273 @@ void PageManager::updateZoneData(ZoneData* zone)
 {
     if (zone) {
         // Potentially validate if the zone belongs to any page managed by this manager, if necessary
+        zone->invalidateSnapshot(); // Caller may have edited icons directly
         emit zoneDataChanged(zone);
+        schedulePublish();
+    }
+}
+
+void PageManager::notifyIconsMoved(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (zone && !iconIds.isEmpty()) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).mergeMoved(iconIds);
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyIconsAdded(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (zone && !iconIds.isEmpty()) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).mergeAdded(iconIds);
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyIconsRemoved(ZoneData* zone, const QList<QUuid>& iconIds)
+{
+    if (zone && !iconIds.isEmpty()) {
+        zone->invalidateSnapshot();
+        QList<QUuid> localIds;
+        for (const QUuid& id : iconIds) {
+            if (ZoneData* source = pendingChangeSet(zone).takeTransfer(id)) {
+                // Arrived in this batch: its row and its widget still belong to the source zone
+                pendingChangeSet(source).mergeRemoved({id});
+            } else {
+                localIds.append(id);
+            }
+        }
+        pendingChangeSet(zone).mergeRemoved(localIds);
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyZoneGeometryChanged(ZoneData* zone)
+{
+    if (zone) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).changes |= ZoneChangeSet::GeometryChange;
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyZoneStyleChanged(ZoneData* zone)
+{
+    if (zone) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).changes |= ZoneChangeSet::StyleChange;
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyZoneTitleChanged(ZoneData* zone)
+{
+    if (zone) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).changes |= ZoneChangeSet::TitleChange;
+        flushPendingChanges();
+    }
+}
+
+void PageManager::notifyZoneStacksChanged(ZoneData* zone)
+{
+    if (zone) {
+        zone->invalidateSnapshot();
+        pendingChangeSet(zone).changes |= ZoneChangeSet::StacksChange;
+        flushPendingChanges();
+    }
+}
+
+QList<QUuid> PageManager::moveIcons(ZoneData* fromZone, ZoneData* toZone, const QList<QUuid>& iconIds,
+                                    const QList<QPointF>& newPositions)
+{
+    QList<QUuid> movedIds;
+    if (!fromZone || !toZone || iconIds.isEmpty()) {
+        return movedIds;
+    }
+    if (fromZone == toZone) {
+        // Plain reposition within one zone
+        for (int i = 0; i < iconIds.size() && i < newPositions.size(); ++i) {
+            if (IconData* icon = fromZone->findIcon(iconIds.at(i))) {
+                icon->setPositionInZone(newPositions.at(i));
+                movedIds.append(iconIds.at(i));
+            }
+        }
+        notifyIconsMoved(fromZone, movedIds);
+        return movedIds;
+    }
+
+    BatchScope batch(this);
+    for (int i = 0; i < iconIds.size(); ++i) {
+        const QUuid& id = iconIds.at(i);
+        IconData* icon = fromZone->takeIcon(id);
+        if (!icon) {
+            qWarning() << "PageManager::moveIcons: Icon" << id << "not found in zone" << fromZone->id();
+            continue;
+        }
+        if (i < newPositions.size()) {
+            icon->setPositionInZone(newPositions.at(i));
+        }
+        toZone->addIcon(icon);
+        movedIds.append(id);
+
+        // Follow the icon back to where its row and widget really are if it already moved in this batch
+        ZoneData* origin = fromZone;
+        ZoneChangeSet& fromChanges = pendingChangeSet(fromZone);
+        if (ZoneData* earlier = fromChanges.takeTransfer(id)) {
+            origin = earlier;
+        }
+        fromChanges.mergeTransferredOut({id});
+
+        if (origin == toZone) {
+            pendingChangeSet(toZone).mergeMoved({id}); // Went out and came back: only the position changed
+        } else {
+            pendingChangeSet(toZone).addTransfer(id, origin);
+        }
     }
+    fromZone->invalidateSnapshot();
+    toZone->invalidateSnapshot();
+    qCDebug(lcZone) << "Moved" << movedIds.size() << "icons from zone" << fromZone->id() << "to zone" << toZone->id();
+    return movedIds; // The batch commits here and emits iconsTransferred once per source zone
+}
+
+// --- Batching ---
+
+void PageManager::beginBatch()
+{
+    ++m_batchDepth;
+}
+
+void PageManager::commitBatch()
+{
+    if (m_batchDepth == 0) {
+        qWarning() << "PageManager::commitBatch: No batch is open.";
+        return;
+    }
+    --m_batchDepth;
+    flushPendingChanges();
+}
+
+ZoneChangeSet& PageManager::pendingChangeSet(ZoneData* zone)
+{
+    for (ZoneChangeSet& changeSet : m_pendingChanges) {
+        if (changeSet.zone == zone) {
+            return changeSet;
+        }
+    }
+    ZoneChangeSet changeSet;
+    changeSet.zone = zone;
+    m_pendingChanges.append(changeSet);
+    return m_pendingChanges.last();
+}
+
+void PageManager::discardPendingChanges(ZoneData* zone)
+{
+    for (int i = m_pendingChanges.size() - 1; i >= 0; --i) {
+        ZoneChangeSet& changeSet = m_pendingChanges[i];
+        if (changeSet.zone == zone) {
+            m_pendingChanges.removeAt(i);
+            continue;
+        }
+        // Icons that left this zone earlier in the batch lose their widget with it; the target creates new ones
+        for (const ZoneChangeSet::Transfer& transfer : std::as_const(changeSet.transfersIn)) {
+            if (transfer.fromZone == zone && changeSet.transferSource(transfer.iconId) == zone) {
+                changeSet.takeTransfer(transfer.iconId);
+                changeSet.mergeAdded({transfer.iconId});
+            }
+        }
+    }
+}
+
+void PageManager::flushPendingChanges()
+{
+    if (m_batchDepth > 0) {
+        return;
+    }
+    if (m_pendingChanges.isEmpty()) {
+        if (m_snapshotDirty) publishSnapshot(); // Page-level changes made inside the batch
+        return;
+    }
+
+    // Take the list first: receivers may start new batches or notify again while we emit
+    QList<ZoneChangeSet> changes;
+    changes.swap(m_pendingChanges);
+    changes.removeIf([](const ZoneChangeSet& changeSet) { return changeSet.isEmpty(); });
+    for (ZoneChangeSet& changeSet : changes) {
+        changeSet.finalize();
+    }
+    if (changes.isEmpty()) {
+        return;
+    }
+
+    for (const ZoneChangeSet& changeSet : changes) {
+        ZoneData* zone = changeSet.zone;
+        // Removals first so a widget for a removed icon never sees a later move
+        if (!changeSet.removedIconIds.isEmpty()) emit iconsRemoved(zone, changeSet.removedIconIds);
+        if (!changeSet.addedIconIds.isEmpty()) emit iconsAdded(zone, changeSet.addedIconIds);
+        if (!changeSet.transfersIn.isEmpty()) {
+            // One signal per source zone
+            QList<ZoneData*> sources;
+            for (const ZoneChangeSet::Transfer& transfer : changeSet.transfersIn) {
+                if (!sources.contains(transfer.fromZone)) sources.append(transfer.fromZone);
+            }
+            for (ZoneData* source : sources) {
+                QList<QUuid> ids;
+                for (const ZoneChangeSet::Transfer& transfer : changeSet.transfersIn) {
+                    if (transfer.fromZone == source) ids.append(transfer.iconId);
+                }
+                emit iconsTransferred(source, zone, ids);
+            }
+        }
+        if (!changeSet.movedIconIds.isEmpty()) emit iconsMoved(zone, changeSet.movedIconIds);
+        if (changeSet.changes.testFlag(ZoneChangeSet::GeometryChange)) emit zoneGeometryChanged(zone);
+        if (changeSet.changes.testFlag(ZoneChangeSet::StyleChange)) emit zoneStyleChanged(zone);
+        if (changeSet.changes.testFlag(ZoneChangeSet::TitleChange)) emit zoneTitleChanged(zone);
+        if (changeSet.changes.testFlag(ZoneChangeSet::StacksChange)) emit zoneStacksChanged(zone);
+    }
+    emit changesCommitted(changes);
+    publishSnapshot();
+}
+
+void PageManager::schedulePublish()
+{
+    if (m_batchDepth > 0) {
+        m_snapshotDirty = true;
+        return;
+    }
+    publishSnapshot();
+}
+
+void PageManager::publishSnapshot()
+{
+    // Unchanged zones hand back their cached ZoneSnapshot, so this is a handful of
+    // reference-count bumps per page plus a rebuild of only the zones that were edited.
+    auto layout = std::make_shared<LayoutSnapshot>();
+    layout->version = ++m_snapshotVersion;
+    layout->activePageIndex = m_activePageIndex;
+    layout->pages.reserve(m_pages.size());
+    for (const PageData* page : m_pages) {
+        PageSnapshotData* data = new PageSnapshotData;
+        data->id = page->id();
+        data->name = page->name();
+        data->wallpaperPath = page->wallpaperPath();
+        data->overlayColor = page->overlayColor();
+        data->zones.reserve(page->zones().size());
+        for (const ZoneData* zone : page->zones()) {
+            data->zones.append(zone->snapshot());
+        }
+        layout->pages.append(PageSnapshot(data));
+    }
+
+    std::atomic_store(&m_snapshot, std::shared_ptr<const LayoutSnapshot>(std::move(layout)));
+    m_snapshotDirty = false;
+    emit snapshotPublished(m_snapshotVersion);
+}
+
+std::shared_ptr<const LayoutSnapshot> PageManager::snapshot() const
+{
+    return std::atomic_load(&m_snapshot);
 }
 
 bool PageManager::renamePage(const QUuid& pageId, const QString& newName)
@@ -210,6 +490,7 @@ bool PageManager::renamePage(const QUuid& pageId, const QString& newName)
         }
         pageToRename->setName(newName);
         emit pageNameChanged(pageToRename);
+        schedulePublish();
         qDebug() << "Page" << pageId << "renamed to" << newName;
         return true;
     }
@@ -243,6 +524,7 @@ void PageManager::movePage(int fromIndex, int toIndex)
     // then an activePageChanged or a specific pageIndexChanged signal might be needed.
 
     emit pageOrderChanged();
+    schedulePublish();
     qDebug() << "Page moved from index" << fromIndex << "to" << toIndex;
 }
 
@@ -254,12 +536,14 @@ void PageManager::addLoadedPage(PageData* pageData) {
         // Emitting pageAdded here would cause MainWindow to create a new tab.
         // This is correct behavior when loading.
         emit pageAdded(pageData, m_pages.size() - 1);
+        schedulePublish();
     }
 }
 
 void PageManager::clearAllPages() {
     // This needs to properly delete all PageData and their owned ZoneData/IconData
     // qDeleteAll uses the delete operator on each pointer in the container and then clears the container.
+    m_pendingChanges.clear(); // Every zone is about to be deleted
     qDeleteAll(m_pages);
     m_pages.clear();
 
@@ -270,6 +554,7 @@ void PageManager::clearAllPages() {
         emit activePageChanged(nullptr, -1);
     }
     // emit allPagesCleared(); // Optional signal if other components need to react to full clear
+    schedulePublish();
     qDebug() << "All pages cleared from PageManager.";
 }
 
@@ -277,6 +562,7 @@ void PageManager::notifyPagePropertiesChanged(PageData* page)
 {
     if (page) {
         emit pagePropertiesChanged(page);
+        schedulePublish();
         // This also implies that the overall state has changed and might need saving.
         // The main application window (MainWindow) will handle calling saveSettings on close,
         // which iterates through all pages and saves their current state.
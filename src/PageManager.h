@@ -4,8 +4,11 @@
 #include <QObject>
 #include <QList>
 #include <QString>
+#include <memory>
 #include "PageData.h"
 #include "ZoneData.h" // Include for signal/slot parameters
+#include "ZoneChangeSet.h"
+#include "LayoutSnapshot.h"
 
 class PageManager : public QObject
 {
@@ -14,6 +17,17 @@ class PageManager : public QObject
 public:
     explicit PageManager(QObject *parent = nullptr);
 
+    // RAII helper: begins a batch on construction and commits it on destruction.
+    class BatchScope
+    {
+    public:
+        explicit BatchScope(PageManager* manager) : m_manager(manager) { if (m_manager) m_manager->beginBatch(); }
+        ~BatchScope() { if (m_manager) m_manager->commitBatch(); }
+    private:
+        Q_DISABLE_COPY(BatchScope)
+        PageManager* m_manager;
+    };
+
     const QList<PageData*>& pages() const;
     PageData* page(int index) const;
     PageData* pageById(const QUuid& id) const;
@@ -26,6 +40,10 @@ public:
     int activePageIndex() const;
     PageData* activePage() const;
 
+    // Latest published layout version. Safe to call from any thread: the root is swapped atomically
+    // and a version is never modified after publication, so readers need no lock.
+    std::shared_ptr<const LayoutSnapshot> snapshot() const;
+
 public slots:
     void setActivePageIndex(int index);
     void setActivePageById(const QUuid& id);
@@ -40,9 +58,28 @@ signals:
     // Zone signals
     void zoneAddedToPage(PageData* page, ZoneData* zone);
     void zoneRemovedFromPage(PageData* page, QUuid zoneId);
-    void zoneDataChanged(ZoneData* zone);
+    void zoneDataChanged(ZoneData* zone); // Whole-zone refresh; prefer the typed deltas below
     void pagePropertiesChanged(PageData* page); // For wallpaper/overlay changes
 
+    // Typed zone deltas. Receivers apply only what changed instead of rebuilding the zone.
+    void iconsMoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void iconsAdded(ZoneData* zone, const QList<QUuid>& iconIds);
+    void iconsRemoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void zoneGeometryChanged(ZoneData* zone);
+    void zoneStyleChanged(ZoneData* zone);   // Color, corner radius, background image or blur
+    void zoneTitleChanged(ZoneData* zone);
+    void zoneStacksChanged(ZoneData* zone);
+    // Icons whose IconData moved from one zone to another (possibly on another page).
+    // Receivers hand the existing IconWidget over instead of deleting and recreating it.
+    void iconsTransferred(ZoneData* fromZone, ZoneData* toZone, const QList<QUuid>& iconIds);
+
+    // Emitted once per committed batch (or per single un-batched notify) after the typed deltas,
+    // with the merged changes for every touched zone. The persistence layer listens to this.
+    void changesCommitted(const QList<ZoneChangeSet>& changes);
+
+    // A new LayoutSnapshot is available through snapshot()
+    void snapshotPublished(quint64 version);
+
 public: // Zone management methods
     ZoneData* addZoneToActivePage(const QString& title, const QRectF& geometry, const QColor& backgroundColor);
     ZoneData* addZoneToPage(const QUuid& pageId, const QString& title, const QRectF& geometry, const QColor& backgroundColor);
@@ -50,6 +87,26 @@ public: // Zone management methods
     bool removeZoneFromPage(const QUuid& pageId, const QUuid& zoneId);
     void updateZoneData(ZoneData* zone); // To be called when a ZoneWidget's data is changed by user interaction
 
+    // Called after the corresponding ZoneData/IconData has been modified
+    void notifyIconsMoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void notifyIconsAdded(ZoneData* zone, const QList<QUuid>& iconIds);
+    void notifyIconsRemoved(ZoneData* zone, const QList<QUuid>& iconIds);
+    void notifyZoneGeometryChanged(ZoneData* zone);
+    void notifyZoneStyleChanged(ZoneData* zone);
+    void notifyZoneTitleChanged(ZoneData* zone);
+    void notifyZoneStacksChanged(ZoneData* zone);
+
+    // Moves icons to another zone by transferring ownership of their IconData; nothing is copied.
+    // newPositions, if given, holds one target position per icon. Returns the IDs actually moved.
+    QList<QUuid> moveIcons(ZoneData* fromZone, ZoneData* toZone, const QList<QUuid>& iconIds,
+                           const QList<QPointF>& newPositions = QList<QPointF>());
+
+    // Batches nest. While one is open, notify*() calls are merged per zone and nothing is emitted;
+    // the outermost commitBatch() emits each zone's typed deltas once, then changesCommitted once.
+    void beginBatch();
+    void commitBatch();
+    bool isBatchOpen() const { return m_batchDepth > 0; }
+
     void addLoadedPage(PageData* pageData); // For DatabaseManager
     void clearAllPages();                   // For DatabaseManager
 
@@ -59,8 +116,21 @@ public: // Zone management methods
 
 
 private:
+    ZoneChangeSet& pendingChangeSet(ZoneData* zone);
+    void discardPendingChanges(ZoneData* zone); // Zone is about to be deleted
+    void flushPendingChanges();
+    void schedulePublish(); // Publishes now, or when the outermost batch commits
+    void publishSnapshot();
+
     QList<PageData*> m_pages;
     int m_activePageIndex;
+
+    int m_batchDepth;
+    QList<ZoneChangeSet> m_pendingChanges; // In first-touched order; few zones per batch, so linear lookup
+
+    std::shared_ptr<const LayoutSnapshot> m_snapshot; // Only touched through std::atomic_load/atomic_store
+    quint64 m_snapshotVersion;
+    bool m_snapshotDirty; // Something changed while a batch was open
 };
 
 #endif // PAGEMANAGER_H
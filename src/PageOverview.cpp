@@ -0,0 +1,216 @@
+#include "PageOverview.h"
+#include "PageThumbnailCache.h"
+#include "StaticTextCache.h"
+#include <QKeyEvent>
+#include <QMouseEvent>
+#include <QPainter>
+#include <QWheelEvent>
+
+namespace {
+
+constexpr int MARGIN = 32;
+constexpr int SPACING = 20;
+constexpr int CAPTION_HEIGHT = 24;
+
+}
+
+PageOverview::PageOverview(PageThumbnailCache* thumbnails, QWidget* parent)
+    : QWidget(parent), m_thumbnails(thumbnails)
+{
+    Q_ASSERT(m_thumbnails);
+    Q_ASSERT(parent);
+    setObjectName("PageOverview");
+    // Opaque, like PageRenderCache's cover: the page and its zones underneath are not painted at all
+    setAttribute(Qt::WA_OpaquePaintEvent);
+    setAttribute(Qt::WA_NoSystemBackground);
+    setMouseTracking(true);
+    setFocusPolicy(Qt::StrongFocus);
+    hide();
+    parent->installEventFilter(this);
+    connect(m_thumbnails, &PageThumbnailCache::thumbnailChanged, this, &PageOverview::handleThumbnailChanged);
+}
+
+void PageOverview::open(const QList<Entry>& pages, const QUuid& currentPageId)
+{
+    m_pages = pages;
+    m_currentPageId = currentPageId;
+    m_hoveredIndex = -1;
+    m_scrollOffset = 0;
+    setGeometry(parentWidget()->rect());
+    raise();
+    show();
+    setFocus(Qt::OtherFocusReason);
+    // The current page in view, e.g. the 40th of 40
+    for (int i = 0; i < m_pages.size(); ++i) {
+        if (m_pages.at(i).pageId == m_currentPageId) {
+            scrollBy(cellRect(i).bottom() + MARGIN - height());
+            break;
+        }
+    }
+}
+
+bool PageOverview::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == parentWidget() && event->type() == QEvent::Resize) {
+        setGeometry(parentWidget()->rect());
+        scrollBy(0); // Clamped to the new height
+    }
+    return false;
+}
+
+QSize PageOverview::thumbnailSize() const
+{
+    const int width = PageThumbnailCache::thumbnailWidth();
+    return QSize(width, qMax(1, width * qMax(1, height()) / qMax(1, this->width())));
+}
+
+int PageOverview::columnCount() const
+{
+    return qMax(1, (width() - 2 * MARGIN + SPACING) / (thumbnailSize().width() + SPACING));
+}
+
+QRect PageOverview::cellRect(int index) const
+{
+    const QSize cellSize = thumbnailSize() + QSize(0, CAPTION_HEIGHT);
+    const int columns = columnCount();
+    const int gridWidth = columns * cellSize.width() + (columns - 1) * SPACING;
+    const int left = qMax(MARGIN, (width() - gridWidth) / 2); // Centered
+    return QRect(left + (index % columns) * (cellSize.width() + SPACING),
+                 MARGIN + (index / columns) * (cellSize.height() + SPACING) - m_scrollOffset,
+                 cellSize.width(), cellSize.height());
+}
+
+int PageOverview::indexAt(const QPoint& pos) const
+{
+    // Cells are a regular grid; only the candidate under pos needs checking
+    const QSize cellSize = thumbnailSize() + QSize(0, CAPTION_HEIGHT);
+    const QRect first = cellRect(0);
+    const int column = (pos.x() - first.left()) / (cellSize.width() + SPACING);
+    const int row = (pos.y() - first.top()) / (cellSize.height() + SPACING);
+    if (pos.x() < first.left() || pos.y() < first.top() || column >= columnCount()) return -1;
+    const int index = row * columnCount() + column;
+    return index < m_pages.size() && cellRect(index).contains(pos) ? index : -1;
+}
+
+void PageOverview::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    painter.setCompositionMode(QPainter::CompositionMode_Source); // Replaces the translucent window's pixels
+    painter.fillRect(event->rect(), QColor(15, 15, 18, 235));
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    painter.setRenderHint(QPainter::Antialiasing);
+
+    const QSize pictureSize = thumbnailSize();
+    for (int i = 0; i < m_pages.size(); ++i) {
+        const QRect cell = cellRect(i);
+        if (!cell.intersects(event->rect())) continue;
+        const QRect pictureRect(cell.topLeft(), pictureSize);
+
+        const QPixmap thumbnail = m_thumbnails->thumbnail(m_pages.at(i).pageId);
+        if (!thumbnail.isNull()) {
+            // Its own size unless the page's aspect ratio changed since it was made
+            QSize size = thumbnail.deviceIndependentSize().toSize();
+            if (size != pictureSize) size.scale(pictureSize, Qt::KeepAspectRatio);
+            const QRect target(pictureRect.topLeft() + QPoint((pictureSize.width() - size.width()) / 2,
+                                                              (pictureSize.height() - size.height()) / 2), size);
+            painter.drawPixmap(target, thumbnail);
+        } else {
+            painter.fillRect(pictureRect, QColor(255, 255, 255, 20)); // Not rendered yet
+        }
+
+        if (m_pages.at(i).pageId == m_currentPageId) {
+            painter.setPen(QPen(QColor(40, 120, 220), 3));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRoundedRect(QRectF(pictureRect).adjusted(-1.5, -1.5, 1.5, 1.5), 4, 4);
+        } else if (i == m_hoveredIndex) {
+            painter.setPen(QPen(QColor(255, 255, 255, 160), 2));
+            painter.setBrush(Qt::NoBrush);
+            painter.drawRoundedRect(QRectF(pictureRect).adjusted(-1, -1, 1, 1), 4, 4);
+        }
+
+        painter.setPen(Qt::white);
+        const QStaticText caption = StaticTextCache::text(m_pages.at(i).name, font(), cell.width(), 1,
+                                                          Qt::ElideRight, Qt::AlignHCenter);
+        painter.drawStaticText(QPointF(cell.left(), pictureRect.bottom() + 1 + (CAPTION_HEIGHT - caption.size().height()) / 2.0),
+                               caption);
+    }
+}
+
+void PageOverview::setHoveredIndex(int index)
+{
+    if (index == m_hoveredIndex) return;
+    if (m_hoveredIndex >= 0) update(cellRect(m_hoveredIndex).adjusted(-3, -3, 3, 3));
+    m_hoveredIndex = index;
+    if (m_hoveredIndex >= 0) update(cellRect(m_hoveredIndex).adjusted(-3, -3, 3, 3));
+}
+
+void PageOverview::mouseMoveEvent(QMouseEvent *event)
+{
+    setHoveredIndex(indexAt(event->position().toPoint()));
+}
+
+void PageOverview::mouseReleaseEvent(QMouseEvent *event)
+{
+    if (event->button() != Qt::LeftButton) return;
+    const int index = indexAt(event->position().toPoint());
+    if (index >= 0) {
+        choose(index);
+    } else {
+        hide(); // A click between pages dismisses, like Escape
+    }
+}
+
+void PageOverview::leaveEvent(QEvent *event)
+{
+    setHoveredIndex(-1);
+    QWidget::leaveEvent(event);
+}
+
+void PageOverview::wheelEvent(QWheelEvent *event)
+{
+    scrollBy(-event->angleDelta().y() * (thumbnailSize().height() + CAPTION_HEIGHT + SPACING) / (2 * 120)); // Half a row per notch
+    setHoveredIndex(indexAt(event->position().toPoint()));
+}
+
+void PageOverview::keyPressEvent(QKeyEvent *event)
+{
+    switch (event->key()) {
+    case Qt::Key_Escape:
+        hide();
+        break;
+    case Qt::Key_Return:
+    case Qt::Key_Enter:
+        if (m_hoveredIndex >= 0) choose(m_hoveredIndex);
+        break;
+    default:
+        QWidget::keyPressEvent(event);
+    }
+}
+
+void PageOverview::scrollBy(int dy)
+{
+    const int rows = (m_pages.size() + columnCount() - 1) / columnCount();
+    const int contentHeight = 2 * MARGIN + rows * (thumbnailSize().height() + CAPTION_HEIGHT + SPACING) - SPACING;
+    const int offset = qBound(0, m_scrollOffset + dy, qMax(0, contentHeight - height()));
+    if (offset == m_scrollOffset) return;
+    m_scrollOffset = offset;
+    update();
+}
+
+void PageOverview::choose(int index)
+{
+    const QUuid pageId = m_pages.at(index).pageId;
+    hide();
+    emit pageChosen(pageId);
+}
+
+void PageOverview::handleThumbnailChanged(const QUuid& pageId)
+{
+    if (!isVisible()) return;
+    for (int i = 0; i < m_pages.size(); ++i) {
+        if (m_pages.at(i).pageId == pageId) {
+            update(cellRect(i));
+            return;
+        }
+    }
+}
@@ -0,0 +1,58 @@
+#ifndef PAGEOVERVIEW_H
+#define PAGEOVERVIEW_H
+
+#include <QWidget>
+#include <QList>
+#include <QString>
+#include <QUuid>
+
+class PageThumbnailCache;
+
+// Every page at once, as a grid of cached thumbnails over the page area. Painting it renders no
+// page: the thumbnails come from PageThumbnailCache, and the overview is opaque, so the page
+// underneath is not painted while it is up either. Click a page, or Return on the hovered one,
+// to pick it; Escape closes.
+class PageOverview : public QWidget
+{
+    Q_OBJECT
+
+public:
+    struct Entry {
+        QUuid pageId;
+        QString name;
+    };
+
+    PageOverview(PageThumbnailCache* thumbnails, QWidget* parent); // Covers parent, and follows its size
+
+    void open(const QList<Entry>& pages, const QUuid& currentPageId);
+
+signals:
+    void pageChosen(const QUuid& pageId); // Then closes itself
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+    void paintEvent(QPaintEvent *event) override;
+    void mouseMoveEvent(QMouseEvent *event) override;
+    void mouseReleaseEvent(QMouseEvent *event) override;
+    void leaveEvent(QEvent *event) override;
+    void wheelEvent(QWheelEvent *event) override;
+    void keyPressEvent(QKeyEvent *event) override;
+
+private:
+    QSize thumbnailSize() const; // One cell's picture; the page's aspect ratio
+    int columnCount() const;
+    QRect cellRect(int index) const; // Picture and caption, scrolled
+    int indexAt(const QPoint& pos) const; // -1 between cells
+    void setHoveredIndex(int index);
+    void scrollBy(int dy);
+    void choose(int index);
+    void handleThumbnailChanged(const QUuid& pageId);
+
+    PageThumbnailCache* m_thumbnails;
+    QList<Entry> m_pages;
+    QUuid m_currentPageId;
+    int m_hoveredIndex = -1;
+    int m_scrollOffset = 0; // Pixels scrolled down
+};
+
+#endif // PAGEOVERVIEW_H
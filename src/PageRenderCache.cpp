@@ -0,0 +1,183 @@
+#include "PageRenderCache.h"
+#include <QElapsedTimer>
+#include <QEvent>
+#include <QPainter>
+#include <QTimer>
+#include <QWidget>
+#include <QDebug>
+#include "Logging.h"
+
+int PageRenderCache::s_maxCachedPages = 8; // A full-window pixmap each; about 8 MB apiece at 1080p
+QList<QPointer<PageRenderCache>> PageRenderCache::s_recentlyUsed;
+
+namespace {
+
+constexpr int IDLE_DELAY_MS = 750;    // After the last change, so a drag or a batch renders once
+constexpr int RENDER_SPACING_MS = 150; // Between renders of different hidden pages, e.g. the neighbours after startup
+
+QElapsedTimer& lastRender()
+{
+    static QElapsedTimer timer;
+    return timer;
+}
+
+}
+
+PageRenderCache::PageRenderCache(QWidget* page)
+    : QObject(page), m_page(page), m_idleTimer(new QTimer(this)), m_cover(new QWidget(page)), m_prerender(false)
+{
+    Q_ASSERT(m_page);
+    m_idleTimer->setSingleShot(true);
+    m_idleTimer->setInterval(IDLE_DELAY_MS);
+    connect(m_idleTimer, &QTimer::timeout, this, &PageRenderCache::render);
+
+    // Opaque, so the zones underneath are not painted at all while it is up
+    m_cover->setAttribute(Qt::WA_OpaquePaintEvent);
+    m_cover->setAttribute(Qt::WA_NoSystemBackground);
+    m_cover->setAttribute(Qt::WA_TransparentForMouseEvents);
+    m_cover->hide();
+    m_cover->installEventFilter(this);
+    m_page->installEventFilter(this);
+}
+
+void PageRenderCache::invalidate(const QRect& rect)
+{
+    if (rect.isEmpty()) return;
+    m_dirty += rect;
+    scheduleRender();
+}
+
+void PageRenderCache::invalidateAll()
+{
+    invalidate(m_page->rect());
+}
+
+bool PageRenderCache::fitsPage() const
+{
+    const qreal dpr = m_page->devicePixelRatioF();
+    return !m_pixmap.isNull() && m_pixmap.devicePixelRatio() == dpr
+           && m_pixmap.size() == (QSizeF(m_page->size()) * dpr).toSize();
+}
+
+bool PageRenderCache::isValid() const
+{
+    return fitsPage() && m_dirty.isEmpty();
+}
+
+void PageRenderCache::setPrerender(bool prerender)
+{
+    if (m_prerender == prerender) return;
+    m_prerender = prerender;
+    if (m_prerender && !isValid()) scheduleRender(); // Changes held back while it was not wanted
+}
+
+bool PageRenderCache::isWanted() const
+{
+    return m_page->isVisible() || m_prerender
+           || s_recentlyUsed.contains(QPointer<PageRenderCache>(const_cast<PageRenderCache*>(this)));
+}
+
+bool PageRenderCache::eventFilter(QObject* watched, QEvent* event)
+{
+    if (watched == m_cover) {
+        if (event->type() == QEvent::Paint) {
+            QPainter painter(m_cover);
+            painter.setCompositionMode(QPainter::CompositionMode_Source); // Copies the page's alpha too
+            painter.drawPixmap(0, 0, m_pixmap);
+            // This frame shows the whole page; the live widgets take over from the next one
+            QTimer::singleShot(0, this, &PageRenderCache::hideCover);
+            return true;
+        }
+        return false;
+    }
+
+    switch (event->type()) {
+    case QEvent::Show:
+        touch();
+        if (fitsPage()) {
+            if (!m_dirty.isEmpty()) render(); // Only what changed while hidden, usually a zone or two
+            showCover();
+        }
+        break;
+    case QEvent::Hide:
+        hideCover();
+        if (!isValid()) scheduleRender();
+        break;
+    case QEvent::Resize:
+        m_dirty = QRegion(); // The next render covers the new size entirely
+        scheduleRender();
+        break;
+    default:
+        break;
+    }
+    return false;
+}
+
+void PageRenderCache::scheduleRender()
+{
+    m_idleTimer->start(IDLE_DELAY_MS); // Restarted by every change
+}
+
+void PageRenderCache::render()
+{
+    if (m_page->width() <= 0 || m_page->height() <= 0) return;
+    if (!isWanted()) return; // m_dirty stays; setPrerender() or the next show renders it
+    if (!m_page->isVisible() && lastRender().isValid() && lastRender().elapsed() < RENDER_SPACING_MS) {
+        m_idleTimer->start(RENDER_SPACING_MS - int(lastRender().elapsed())); // Another page just rendered
+        return;
+    }
+
+    QElapsedTimer timer;
+    timer.start();
+    QRegion region = m_dirty;
+    if (!fitsPage()) {
+        const qreal dpr = m_page->devicePixelRatioF();
+        m_pixmap = QPixmap((QSizeF(m_page->size()) * dpr).toSize());
+        m_pixmap.setDevicePixelRatio(dpr);
+        region = m_page->rect();
+    }
+    region &= m_page->rect();
+    m_dirty = QRegion();
+    if (region.isEmpty()) return;
+
+    QPainter painter(&m_pixmap);
+    painter.setClipRegion(region);
+    painter.setCompositionMode(QPainter::CompositionMode_Source);
+    painter.fillRect(region.boundingRect(), Qt::transparent); // Clipped; the page may not cover every pixel
+    painter.setCompositionMode(QPainter::CompositionMode_SourceOver);
+    // Hidden pages render too: their zones are not hidden themselves, only through the page
+    m_page->render(&painter, QPoint(), region, QWidget::DrawWindowBackground | QWidget::DrawChildren);
+    painter.end();
+
+    lastRender().start();
+    qCDebug(lcImage) << "Rendered page" << m_page->objectName() << region.boundingRect()
+                    << "in" << timer.elapsed() << "ms";
+    touch(); // Kept over pages neither shown nor changed since, so its next change renders only itself
+    emit rendered(region); // E.g. for the page's thumbnail
+}
+
+void PageRenderCache::showCover()
+{
+    m_cover->setGeometry(m_page->rect());
+    m_cover->raise(); // Above the zones
+    m_cover->show();
+}
+
+void PageRenderCache::hideCover()
+{
+    if (m_cover->isHidden()) return;
+    m_cover->hide(); // Exposes the live page underneath
+}
+
+void PageRenderCache::touch()
+{
+    s_recentlyUsed.removeAll(QPointer<PageRenderCache>(this));
+    s_recentlyUsed.removeAll(QPointer<PageRenderCache>()); // Pages closed meanwhile
+    s_recentlyUsed.prepend(this);
+    while (s_recentlyUsed.size() > qMax(1, s_maxCachedPages)) {
+        if (PageRenderCache* evicted = s_recentlyUsed.takeLast()) {
+            // A render still scheduled stays scheduled, and covers the whole page now
+            evicted->m_pixmap = QPixmap();
+        }
+    }
+}
@@ -0,0 +1,63 @@
+#ifndef PAGERENDERCACHE_H
+#define PAGERENDERCACHE_H
+
+#include <QList>
+#include <QObject>
+#include <QPixmap>
+#include <QPointer>
+#include <QRegion>
+
+class QTimer;
+class QWidget;
+
+// Offscreen render of one page, wallpaper and zones included, so switching to its tab shows the
+// whole page in the first frame. Rendered on an idle timer once the page has settled; that render
+// also polishes the widgets and starts their image decodes, so the live page that replaces the
+// snapshot one frame later is mostly cached already. Only the rects the page invalidates are
+// rendered again. Selection and hover are not tracked and may be a frame stale.
+// QWidget::render() only works on the GUI thread, so "in the background" means idle time there,
+// with renders of hidden pages spaced apart. Hidden pages render only while they are likely to be
+// shown next: the tabs beside the current one (see setPrerender()) and the recently used pages.
+// GUI thread only.
+class PageRenderCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PageRenderCache(QWidget* page); // Owned by page; watches its show, hide and resize events
+
+    void invalidate(const QRect& rect); // Page coordinates; for changes made while the page is hidden
+    void invalidateAll();
+    bool isValid() const; // Rendered, and for the page's current size and device pixel ratio
+    void setPrerender(bool prerender); // Render while hidden even if not recently used, e.g. a neighbouring tab
+    QPixmap pixmap() const { return m_pixmap; }
+
+    static void setMaxCachedPages(int count) { s_maxCachedPages = count; } // Pages beyond it drop theirs, least recently used first
+
+signals:
+    void rendered(const QRegion& region); // Page coordinates; pixmap() holds them until the next render
+
+protected:
+    bool eventFilter(QObject* watched, QEvent* event) override;
+
+private:
+    void scheduleRender();
+    bool fitsPage() const; // m_pixmap has the page's device size and pixel ratio
+    bool isWanted() const; // Shown, prerendered or recently used; other pages keep their changes for later
+    void render(); // Renders m_dirty into m_pixmap, or everything if the pixmap does not fit the page
+    void showCover();
+    void hideCover();
+    void touch(); // Most recently used (shown or rendered); evicts the renders of pages over the limit
+
+    QWidget* m_page;
+    QPixmap m_pixmap; // Null once evicted; the next render is then a full one
+    QRegion m_dirty;  // Page coordinates, changed since the last render
+    QTimer* m_idleTimer;
+    QWidget* m_cover; // Opaque child showing m_pixmap for the first frame after a switch
+    bool m_prerender;
+
+    static int s_maxCachedPages;
+    static QList<QPointer<PageRenderCache>> s_recentlyUsed; // Most recent first
+};
+
+#endif // PAGERENDERCACHE_H
@@ -4,16 +4,30 @@
 #include "ZoneData.h"
 #include "PageManager.h"
 #include <QDebug>
+#include "Logging.h"
 #include <QVBoxLayout>
 #include <QPainter> // For paintEvent
 #include <QPixmap>  // For wallpaper
+#include <QTimer>
+#include <QtConcurrent/QtConcurrent> // For rescaling the wallpaper on the thread pool
+#include "ImageDecodeService.h"
+#include "PerfMonitor.h" // For paint timings on the performance HUD
+#include "PageRenderCache.h"
 
 PageTabContentWidget::PageTabContentWidget(PageData* pageData, PageManager* pageManager, QWidget *parent)
-    : QWidget(parent), m_pageData(pageData), m_pageManager(pageManager)
+    : QWidget(parent), m_pageData(pageData), m_pageManager(pageManager),
+      m_wallpaperWatcher(new QFutureWatcher<QImage>(this)),
+      m_wallpaperRescaleTimer(new QTimer(this)),
+      m_renderCache(new PageRenderCache(this))
 {
     Q_ASSERT(m_pageData);
     Q_ASSERT(m_pageManager);
 
+    connect(m_wallpaperWatcher, &QFutureWatcher<QImage>::finished, this, &PageTabContentWidget::handleScaledWallpaperReady);
+    m_wallpaperRescaleTimer->setSingleShot(true);
+    m_wallpaperRescaleTimer->setInterval(80); // A resize drag settles into one rescale
+    connect(m_wallpaperRescaleTimer, &QTimer::timeout, this, &PageTabContentWidget::requestScaledWallpaper);
+
     // Set object name for debugging if needed
     setObjectName(QString("PageTabContent_%1").arg(m_pageData->id().toString()));
 
@@ -33,6 +47,7 @@ PageTabContentWidget::PageTabContentWidget(PageData* pageData, PageManager* page
 
 PageTabContentWidget::~PageTabContentWidget()
 {
+    m_wallpaperDecodeTicket.cancel();
     // ZoneWidgets are children of this widget, so Qt should handle their deletion.
     // m_zoneWidgets list just stores pointers, doesn't own them after they are parented.
     qDebug() << "PageTabContentWidget for page ID" << pageId() << "destroyed.";
@@ -51,41 +66,148 @@ void PageTabContentWidget::loadInitialZones()
         if (zd) {
             ZoneWidget* zw = new ZoneWidget(zd, m_pageManager, this); // Parent is this PageTabContentWidget
             m_zoneWidgets.append(zw);
+            m_zoneWidgetById.insert(zd->id(), zw);
+            connect(zw, &ZoneWidget::iconDroppedOutside, this, &PageTabContentWidget::iconDroppedOutsideZones);
+            connectZoneContent(zw);
             zw->show(); // Make sure it's visible
-            qDebug() << "Loaded initial zone:" << zd->title() << "on page" << pageId();
+            qCDebug(lcZone) << "Loaded initial zone:" << zd->title() << "on page" << pageId();
         }
     }
 }
 
+void PageTabContentWidget::invalidateRender()
+{
+    m_renderCache->invalidateAll();
+}
+
+void PageTabContentWidget::invalidateZoneRender(ZoneWidget* zoneWidget, const QRect& previousGeometry)
+{
+    // A hidden page gets no paint events, so its deltas are reported here. The margin covers the drop shadow.
+    const QMargins shadowMargins = ZoneWidget::shadowMargins();
+    if (!previousGeometry.isNull()) m_renderCache->invalidate(previousGeometry.marginsAdded(shadowMargins));
+    if (zoneWidget) m_renderCache->invalidate(zoneWidget->geometry().marginsAdded(shadowMargins));
+}
+
+bool PageTabContentWidget::hasPendingContent() const
+{
+    if (m_wallpaperDecodePending || m_wallpaperWatcher->isRunning()) return true;
+    for (ZoneWidget* zoneWidget : m_zoneWidgets) {
+        if (zoneWidget->hasPendingContent()) return true;
+    }
+    return false;
+}
+
+void PageTabContentWidget::connectZoneContent(ZoneWidget* zoneWidget)
+{
+    // Decodes and icon lookups finish after the page may have rendered their placeholders
+    connect(zoneWidget, &ZoneWidget::contentReady, this, [this, zoneWidget](const QRect& rect) {
+        m_renderCache->invalidate(rect.translated(zoneWidget->pos()));
+    });
+}
+
 void PageTabContentWidget::loadPageWallpaper() {
+    m_wallpaperDecodeTicket.cancel(); // Only the newest path's result is wanted
+    m_wallpaperImage = QImage();
+    m_scaledWallpaper = QPixmap(); // Never show the previous wallpaper for a new path
+    m_scaledWallpaperKey = WallpaperKey();
+    m_wallpaperDecodePending = false;
+    m_wallpaperRequestedSize = QSize();
+
     if (!m_pageData || m_pageData->wallpaperPath().isEmpty()) {
-        m_cachedWallpaper = QPixmap();
         m_loadedWallpaperPath.clear();
+        m_renderCache->invalidateAll();
         update(); // Repaint, as wallpaper might have been cleared
         return;
     }
 
-    if (m_loadedWallpaperPath == m_pageData->wallpaperPath() && !m_cachedWallpaper.isNull()) {
-        // Already loaded and path hasn't changed
+    // Remembered immediately, so a path that fails to load is not requested again every paint
+    m_loadedWallpaperPath = m_pageData->wallpaperPath();
+    requestWallpaperDecode();
+    update(); // Placeholder until the decode finishes
+}
+
+void PageTabContentWidget::requestWallpaperDecode()
+{
+    m_wallpaperDecodeTicket.cancel();
+    ImageDecodeRequest request;
+    request.path = m_loadedWallpaperPath;
+    // Decoded just large enough to cover the page; the rescale worker then fits it exactly
+    request.targetSize = ImageDecodeService::bucketedSize((QSizeF(size()) * devicePixelRatioF()).toSize());
+    m_wallpaperRequestedSize = request.targetSize;
+    m_wallpaperDecodePending = true;
+    m_wallpaperDecodeTicket = ImageDecodeService::instance()->decode(request, this, [this](const QImage& image) {
+        handleWallpaperDecoded(image);
+    });
+}
+
+void PageTabContentWidget::handleWallpaperDecoded(const QImage& image)
+{
+    m_wallpaperDecodePending = false;
+    if (image.isNull()) {
+        qWarning() << "Failed to load page wallpaper:" << m_loadedWallpaperPath;
+        m_renderCache->invalidateAll(); // The decoding placeholder goes
+        update();
         return;
     }
+    m_wallpaperImage = image; // Shares the cached pixels
+    qCDebug(lcPage) << "Loaded page wallpaper:" << m_loadedWallpaperPath << "decoded at" << image.size();
+    requestScaledWallpaper(); // Scaled on the pool too; painted once that arrives
+}
 
-    QPixmap pixmap(m_pageData->wallpaperPath());
-    if (pixmap.isNull()) {
-        qWarning() << "Failed to load page wallpaper:" << m_pageData->wallpaperPath();
-        m_cachedWallpaper = QPixmap(); // Ensure it's cleared on failure
-    } else {
-        m_cachedWallpaper = pixmap;
-        qDebug() << "Loaded page wallpaper:" << m_pageData->wallpaperPath();
+PageTabContentWidget::WallpaperKey PageTabContentWidget::currentWallpaperKey() const
+{
+    WallpaperKey key;
+    key.path = m_loadedWallpaperPath;
+    key.size = size();
+    key.devicePixelRatio = devicePixelRatioF();
+    key.sourceCacheKey = m_wallpaperImage.cacheKey(); // A sharper decode after growing invalidates the rescale
+    return key;
+}
+
+void PageTabContentWidget::requestScaledWallpaper()
+{
+    if (m_wallpaperImage.isNull() || width() <= 0 || height() <= 0) return;
+    if (m_wallpaperWatcher->isRunning()) return; // handleScaledWallpaperReady checks the key again
+    const WallpaperKey key = currentWallpaperKey();
+    if (key == m_scaledWallpaperKey) return;
+
+    m_inFlightWallpaperKey = key;
+    const QImage source = m_wallpaperImage; // Implicitly shared; the worker only reads it
+    const QSize deviceSize = (QSizeF(key.size) * key.devicePixelRatio).toSize();
+    qCDebug(lcPage) << "Rescaling wallpaper for page" << pageId() << "to" << deviceSize;
+    m_wallpaperWatcher->setFuture(QtConcurrent::run([source, deviceSize]() {
+        return source.scaled(deviceSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+    }));
+}
+
+void PageTabContentWidget::handleScaledWallpaperReady()
+{
+    const QImage scaled = m_wallpaperWatcher->result();
+    if (m_inFlightWallpaperKey.path == m_loadedWallpaperPath && !scaled.isNull()) {
+        m_scaledWallpaper = QPixmap::fromImage(scaled);
+        m_scaledWallpaper.setDevicePixelRatio(m_inFlightWallpaperKey.devicePixelRatio);
+        m_scaledWallpaperKey = m_inFlightWallpaperKey;
+        m_renderCache->invalidateAll();
+        update();
+    }
+    // The page may have been resized or given a new wallpaper meanwhile: one more pass
+    if (currentWallpaperKey() != m_scaledWallpaperKey && !m_wallpaperRescaleTimer->isActive()) {
+        requestScaledWallpaper();
     }
-    m_loadedWallpaperPath = m_pageData->wallpaperPath();
-    update(); // Repaint with new/cleared wallpaper
 }
 
+void PageTabContentWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    if (!m_wallpaperImage.isNull()) {
+        m_wallpaperRescaleTimer->start(); // Restarted by every resize step
+    }
+}
 
 void PageTabContentWidget::paintEvent(QPaintEvent *event)
 {
-    Q_UNUSED(event);
+    PerfMonitor::PaintScope paintTiming(PerfMonitor::PaintKind::Page,
+                                        [this] { return m_pageData ? m_pageData->name() : QString(); });
     QPainter painter(this);
 
     if (!m_pageData) {
@@ -93,20 +215,40 @@ void PageTabContentWidget::paintEvent(QPaintEvent *event)
         return;
     }
 
-    // 1. Check and load wallpaper if path changed
-    if (m_loadedWallpaperPath != m_pageData->wallpaperPath() ||
-        (!m_pageData->wallpaperPath().isEmpty() && m_cachedWallpaper.isNull())) {
+    // Every layer below is copied or filled only where the region was invalidated. A zone or icon
+    // drag step exposes two zone-sized rects at most, not the whole page.
+    const QRegion exposed = event->region();
+
+    // 1. Check and load wallpaper if path changed (a failed path is not retried every frame).
+    //    Growing past the decoded size asks for a sharper decode; the current one stays up meanwhile.
+    if (m_loadedWallpaperPath != m_pageData->wallpaperPath()) {
         loadPageWallpaper();
+    } else if (!m_loadedWallpaperPath.isEmpty()
+               && ImageDecodeService::exceeds((QSizeF(size()) * devicePixelRatioF()).toSize(), m_wallpaperRequestedSize)) {
+        requestWallpaperDecode();
     }
 
-    // 2. Draw wallpaper
-    if (!m_cachedWallpaper.isNull()) {
-        // Scale to cover, maintaining aspect ratio (Qt::KeepAspectRatioByExpanding)
-        // Then it will be clipped by the widget's bounds naturally.
-        QPixmap scaledWallpaper = m_cachedWallpaper.scaled(size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        QPointF pixmapOrigin = QPointF((width() - scaledWallpaper.width()) / 2.0,
-                                       (height() - scaledWallpaper.height()) / 2.0);
-        painter.drawPixmap(pixmapOrigin, scaledWallpaper);
+    // 2. Draw wallpaper. Never scaled smoothly here; the worker delivers a version at the exact size.
+    if (!m_wallpaperImage.isNull() && currentWallpaperKey() != m_scaledWallpaperKey
+        && !m_wallpaperWatcher->isRunning() && !m_wallpaperRescaleTimer->isActive()) {
+        m_wallpaperRescaleTimer->start(); // E.g. moved to a screen with another device pixel ratio
+    }
+    if (!m_scaledWallpaper.isNull()) {
+        const QSizeF scaledSize = m_scaledWallpaper.deviceIndependentSize();
+        // Exact size: centered 1:1. Stale size: the previous version stretched to cover until the new one arrives.
+        const qreal factor = m_scaledWallpaperKey.size == size()
+                                 ? 1.0 : qMax(width() / scaledSize.width(), height() / scaledSize.height());
+        const QSizeF coverSize = scaledSize * factor;
+        const QPointF origin((width() - coverSize.width()) / 2.0, (height() - coverSize.height()) / 2.0);
+        const qreal sourceScale = m_scaledWallpaper.devicePixelRatio() / factor; // Logical target -> pixmap pixels
+        for (const QRect& rect : exposed) {
+            const QRectF source((QPointF(rect.topLeft()) - origin) * sourceScale, QSizeF(rect.size()) * sourceScale);
+            painter.drawPixmap(QRectF(rect), m_scaledWallpaper, source); // QPainter trims a source past the edges
+        }
+    } else if (m_wallpaperDecodePending || !m_wallpaperImage.isNull()) {
+        for (const QRect& rect : exposed) {
+            painter.fillRect(rect, QColor(30, 30, 30, 120)); // Placeholder while decoding or scaling
+        }
     } else {
         // If no wallpaper, or failed to load, some fallback background might be desired
         // For now, if main window is transparent, this will be transparent.
@@ -116,7 +258,15 @@ void PageTabContentWidget::paintEvent(QPaintEvent *event)
 
     // 3. Draw overlay color
     if (m_pageData->overlayColor().alpha() > 0) {
-        painter.fillRect(rect(), m_pageData->overlayColor());
+        const QColor overlayColor = m_pageData->overlayColor();
+        for (const QRect& rect : exposed) {
+            painter.fillRect(rect, overlayColor);
+        }
+    }
+
+    // 4. Zone shadows: nine-patch blits under each zone, never a blur
+    for (ZoneWidget* zoneWidget : m_zoneWidgets) {
+        zoneWidget->paintShadow(&painter, exposed); // The region: a group drag's bounding rect spans most shadows
     }
 
     // ZoneWidgets are children and will paint themselves on top.
@@ -136,9 +286,13 @@ void PageTabContentWidget::handleZoneAdded(PageData* page, ZoneData* zoneData)
 
     ZoneWidget* newZoneWidget = new ZoneWidget(zoneData, m_pageManager, this);
     m_zoneWidgets.append(newZoneWidget);
+    m_zoneWidgetById.insert(zoneData->id(), newZoneWidget);
+    connect(newZoneWidget, &ZoneWidget::iconDroppedOutside, this, &PageTabContentWidget::iconDroppedOutsideZones);
+    connectZoneContent(newZoneWidget);
     newZoneWidget->show(); // Important: make the new widget visible
     newZoneWidget->raise(); // Bring to front if overlapping
-    qDebug() << "Added ZoneWidget for zone" << zoneData->title() << "ID" << zoneData->id() << "to page" << pageId();
+    invalidateZoneRender(newZoneWidget);
+    qCDebug(lcPage) << "Added ZoneWidget for zone" << zoneData->title() << "ID" << zoneData->id() << "to page" << pageId();
     update(); // Repaint parent to ensure it's all good
 }
 
@@ -148,14 +302,14 @@ void PageTabContentWidget::handleZoneRemoved(PageData* page, QUuid zoneId)
         return; // Not for this page
     }
 
-    for (int i = 0; i < m_zoneWidgets.size(); ++i) {
-        if (m_zoneWidgets.at(i)->data()->id() == zoneId) {
-            ZoneWidget* zw = m_zoneWidgets.takeAt(i);
-            qDebug() << "Removing ZoneWidget for zone ID" << zoneId << "from page" << pageId();
-            zw->deleteLater(); // Safe deletion
-            update(); // Repaint parent
-            return;
-        }
+    ZoneWidget* zw = m_zoneWidgetById.take(zoneId);
+    if (zw) {
+        m_zoneWidgets.removeOne(zw);
+        invalidateZoneRender(nullptr, zw->geometry());
+        qCDebug(lcPage) << "Removing ZoneWidget for zone ID" << zoneId << "from page" << pageId();
+        zw->deleteLater(); // Safe deletion
+        update(); // Repaint parent
+        return;
     }
     qWarning() << "ZoneWidget for ID" << zoneId << "not found for removal on page" << pageId();
 }
@@ -168,9 +322,11 @@ void PageTabContentWidget::handleZoneDataChanged(ZoneData* zoneData)
     if (zw) {
         // Check if the zone still belongs to this page, though m_pageManager should emit this
         // only if the zone is relevant.
-        if (m_pageData && m_pageData->zoneById(zoneData->id())) {
-             qDebug() << "Updating ZoneWidget for zone" << zoneData->title() << "ID" << zoneData->id();
+        if (zoneData->pageId() == pageId()) {
+             qCDebug(lcPage) << "Updating ZoneWidget for zone" << zoneData->title() << "ID" << zoneData->id();
+            const QRect previousGeometry = zw->geometry();
             zw->updateFromData(); // ZoneWidget updates its geometry and repaints
+            invalidateZoneRender(zw, previousGeometry);
         } else {
             qWarning() << "Received ZoneDataChanged for zone" << zoneData->id() << "but it's not on current page" << pageId();
         }
@@ -179,23 +335,106 @@ void PageTabContentWidget::handleZoneDataChanged(ZoneData* zoneData)
     }
 }
 
+void PageTabContentWidget::handleIconsMoved(ZoneData* zoneData, const QList<QUuid>& iconIds)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyIconsMoved(iconIds);
+        invalidateZoneRender(zw);
+    }
+}
+
+void PageTabContentWidget::handleIconsAdded(ZoneData* zoneData, const QList<QUuid>& iconIds)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyIconsAdded(iconIds);
+        invalidateZoneRender(zw);
+    }
+}
+
+void PageTabContentWidget::handleIconsRemoved(ZoneData* zoneData, const QList<QUuid>& iconIds)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyIconsRemoved(iconIds);
+        invalidateZoneRender(zw);
+    }
+}
+
+void PageTabContentWidget::handleZoneGeometryChanged(ZoneData* zoneData)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        const QRect previousGeometry = zw->geometry();
+        zw->applyGeometryChanged();
+        invalidateZoneRender(zw, previousGeometry);
+    }
+}
 
-ZoneWidget* PageTabContentWidget::findZoneWidget(const QUuid& zoneId)
+void PageTabContentWidget::handleZoneStyleChanged(ZoneData* zoneData)
 {
-    for (ZoneWidget* zw : m_zoneWidgets) {
-        if (zw->data() && zw->data()->id() == zoneId) {
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyStyleChanged();
+        invalidateZoneRender(zw);
+    }
+}
+
+void PageTabContentWidget::handleZoneTitleChanged(ZoneData* zoneData)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyTitleChanged();
+        invalidateZoneRender(zw);
+    }
+}
+
+void PageTabContentWidget::handleZoneStacksChanged(ZoneData* zoneData)
+{
+    if (!zoneData) return;
+    if (ZoneWidget* zw = findZoneWidget(zoneData->id())) {
+        zw->applyStacksChanged();
+        invalidateZoneRender(zw);
+    }
+}
+
+
+ZoneWidget* PageTabContentWidget::findZoneWidget(const QUuid& zoneId) const
+{
+    return m_zoneWidgetById.value(zoneId, nullptr);
+}
+
+ZoneWidget* PageTabContentWidget::zoneWidgetAt(const QPoint& pos) const
+{
+    // Not childAt(): an icon or other child of a zone would be found instead of the zone.
+    // Zones created later (or raised on add) stack above earlier ones.
+    for (int i = m_zoneWidgets.size() - 1; i >= 0; --i) {
+        ZoneWidget* zw = m_zoneWidgets.at(i);
+        if (zw->isVisible() && zw->geometry().contains(pos)) {
             return zw;
         }
     }
     return nullptr;
 }
 
+void PageTabContentWidget::refreshIconRenderMode()
+{
+    for (ZoneWidget* zoneWidget : m_zoneWidgets) {
+        if (zoneWidget) {
+            zoneWidget->refreshIconRenderMode();
+        }
+    }
+    m_renderCache->invalidateAll();
+}
+
 void PageTabContentWidget::filterIcons(const QString& filterText)
 {
-    qDebug() << "PageTabContentWidget for page" << pageId() << "filtering icons with text:" << filterText;
+    qCDebug(lcFilter) << "PageTabContentWidget for page" << pageId() << "filtering icons with text:" << filterText;
     for (ZoneWidget* zoneWidget : m_zoneWidgets) {
         if (zoneWidget) {
             zoneWidget->filterIcons(filterText);
         }
     }
+    m_renderCache->invalidateAll();
 }
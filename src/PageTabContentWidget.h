@@ -4,6 +4,14 @@
 #include <QWidget>
 #include <QUuid>
 #include <QList> // For storing ZoneWidgets
+#include <QHash>
+#include <QImage>
+#include <QPixmap>
+#include <QFutureWatcher>
+#include "ImageDecodeService.h" // For ImageDecodeTicket
+
+class QTimer;
+class PageRenderCache;
 
 class ZoneWidget; // Forward declaration
 class PageManager; // Forward declaration
@@ -21,26 +29,76 @@ public:
     PageData* pageData() const { return m_pageData; }
 
     void filterIcons(const QString& filterText); // New method for icon filtering
+    void refreshIconRenderMode(); // After ZoneWidget::setPaintIconsAlways changed
+    ZoneWidget* findZoneWidget(const QUuid& zoneId) const;
+    ZoneWidget* zoneWidgetAt(const QPoint& pos) const; // Topmost visible zone under pos, or null
+
+    PageRenderCache* renderCache() const { return m_renderCache; } // Shown for the first frame after switching to this page
+    void invalidateRender(); // After a change that update() alone does not report, e.g. page properties
+    bool hasPendingContent() const; // Wallpaper or zone content still loading; its render shows placeholders
 
 public slots:
     void handleZoneAdded(PageData* page, ZoneData* zoneData);
     void handleZoneRemoved(PageData* page, QUuid zoneId);
     void handleZoneDataChanged(ZoneData* zoneData); // To update existing ZoneWidget
 
+    // Typed deltas, forwarded to the matching ZoneWidget
+    void handleIconsMoved(ZoneData* zoneData, const QList<QUuid>& iconIds);
+    void handleIconsAdded(ZoneData* zoneData, const QList<QUuid>& iconIds);
+    void handleIconsRemoved(ZoneData* zoneData, const QList<QUuid>& iconIds);
+    void handleZoneGeometryChanged(ZoneData* zoneData);
+    void handleZoneStyleChanged(ZoneData* zoneData);
+    void handleZoneTitleChanged(ZoneData* zoneData);
+    void handleZoneStacksChanged(ZoneData* zoneData);
+
+signals:
+    void iconDroppedOutsideZones(ZoneData* fromZone, const QUuid& iconId, const QPoint& globalPos);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void resizeEvent(QResizeEvent *event) override;
 
 private:
     void loadInitialZones();
-    ZoneWidget* findZoneWidget(const QUuid& zoneId);
-    void loadPageWallpaper();
+    void invalidateZoneRender(ZoneWidget* zoneWidget, const QRect& previousGeometry = QRect());
+    void connectZoneContent(ZoneWidget* zoneWidget); // Late content of the zone invalidates its render
+    void loadPageWallpaper(); // Requests an asynchronous decode of the page's wallpaper path
+    void requestWallpaperDecode(); // For the loaded path at the current size
+    void handleWallpaperDecoded(const QImage& image);
+
+    // The cover-scaled wallpaper is produced on a worker, once per (path, size, device pixel ratio, source)
+    struct WallpaperKey {
+        QString path;
+        QSize size;
+        qreal devicePixelRatio = 0;
+        qint64 sourceCacheKey = 0; // QImage::cacheKey() of the decoded source
+
+        bool operator==(const WallpaperKey& other) const {
+            return path == other.path && size == other.size && devicePixelRatio == other.devicePixelRatio
+                   && sourceCacheKey == other.sourceCacheKey;
+        }
+        bool operator!=(const WallpaperKey& other) const { return !(*this == other); }
+    };
+    WallpaperKey currentWallpaperKey() const;
+    void requestScaledWallpaper(); // Starts one worker rescale unless one is running or the cache is current
+    void handleScaledWallpaperReady();
 
     PageData* m_pageData;       // Reference to the page data this widget displays
     PageManager* m_pageManager; // To interact with (e.g. for ZoneWidget context menus)
     QList<ZoneWidget*> m_zoneWidgets;
+    QHash<QUuid, ZoneWidget*> m_zoneWidgetById; // Same widgets keyed by zone ID
 
-    QPixmap m_cachedWallpaper;
-    QString m_loadedWallpaperPath;
+    QImage m_wallpaperImage;       // Full-resolution source; a QImage so the worker may read it
+    QString m_loadedWallpaperPath;  // Path last requested from the decode service
+    ImageDecodeTicket m_wallpaperDecodeTicket;
+    bool m_wallpaperDecodePending = false;
+    QSize m_wallpaperRequestedSize; // Device size the last decode covers; growing past it re-decodes
+    QPixmap m_scaledWallpaper;     // Last finished rescale; painted (stretched if stale) until the next arrives
+    WallpaperKey m_scaledWallpaperKey;
+    WallpaperKey m_inFlightWallpaperKey;
+    QFutureWatcher<QImage>* m_wallpaperWatcher;
+    QTimer* m_wallpaperRescaleTimer; // Debounces resizes and screen changes into one rescale
+    PageRenderCache* m_renderCache;
 };
 
 #endif // PAGETABCONTENTWIDGET_H
@@ -0,0 +1,104 @@
+#include "PageThumbnailCache.h"
+#include "DatabaseManager.h"
+#include <QBuffer>
+#include <QPainter>
+#include <QTimer>
+#include <QDebug>
+#include "Logging.h"
+
+PageThumbnailCache::PageThumbnailCache(DatabaseManager* dbManager, QObject* parent)
+    : QObject(parent), m_dbManager(dbManager), m_flushTimer(new QTimer(this))
+{
+    Q_ASSERT(m_dbManager);
+    m_flushTimer->setSingleShot(true);
+    m_flushTimer->setInterval(5000);
+    connect(m_flushTimer, &QTimer::timeout, this, &PageThumbnailCache::flush);
+}
+
+void PageThumbnailCache::load()
+{
+    const QHash<QUuid, QByteArray> pngByPageId = m_dbManager->loadThumbnails();
+    for (auto it = pngByPageId.constBegin(); it != pngByPageId.constEnd(); ++it) {
+        if (m_thumbnails.contains(it.key())) continue; // Already rendered this session
+        QPixmap thumbnail;
+        if (!thumbnail.loadFromData(it.value(), "PNG")) {
+            qWarning() << "Failed to decode stored thumbnail of page" << it.key();
+            continue;
+        }
+        // Stored at the pixel ratio it was rendered with; its width tells which
+        thumbnail.setDevicePixelRatio(qMax(1.0, qreal(thumbnail.width()) / thumbnailWidth()));
+        m_thumbnails.insert(it.key(), thumbnail);
+    }
+    qCDebug(lcImage) << "Loaded" << m_thumbnails.size() << "page thumbnails";
+}
+
+void PageThumbnailCache::flush()
+{
+    m_flushTimer->stop();
+    QHash<QUuid, QByteArray> pngByPageId;
+    for (const QUuid& pageId : std::as_const(m_unsaved)) {
+        if (m_incomplete.contains(pageId)) continue; // The stored one stays until this is complete
+        const QPixmap thumbnail = m_thumbnails.value(pageId);
+        if (thumbnail.isNull()) continue;
+        QByteArray png;
+        QBuffer buffer(&png);
+        buffer.open(QIODevice::WriteOnly);
+        if (thumbnail.save(&buffer, "PNG")) {
+            pngByPageId.insert(pageId, png);
+        }
+    }
+    if (m_dbManager->saveThumbnails(pngByPageId)) {
+        m_unsaved = m_incomplete & m_unsaved;
+    }
+}
+
+void PageThumbnailCache::removePage(const QUuid& pageId)
+{
+    m_thumbnails.remove(pageId);
+    m_unsaved.remove(pageId);
+    m_incomplete.remove(pageId); // The stored one goes with the next full save
+}
+
+void PageThumbnailCache::updateFromRender(const QUuid& pageId, const QPixmap& pageRender, const QRegion& region,
+                                          bool complete)
+{
+    if (pageRender.isNull() || region.isEmpty()) return;
+
+    const qreal dpr = pageRender.devicePixelRatio();
+    const qreal scale = thumbnailWidth() * dpr / pageRender.width(); // Render pixels -> thumbnail pixels
+    const QSize thumbnailSize(qRound(pageRender.width() * scale), qMax(1, qRound(pageRender.height() * scale)));
+
+    QPixmap& thumbnail = m_thumbnails[pageId];
+    QRegion deviceRegion;
+    if (thumbnail.size() != thumbnailSize || thumbnail.devicePixelRatio() != dpr) {
+        thumbnail = QPixmap(thumbnailSize); // New page, new page size or a stored one from another screen
+        thumbnail.setDevicePixelRatio(dpr);
+        deviceRegion = QRect(QPoint(0, 0), pageRender.size());
+    } else {
+        for (const QRect& rect : region) {
+            deviceRegion += QRectF(QPointF(rect.topLeft()) * dpr, QSizeF(rect.size()) * dpr).toAlignedRect();
+        }
+    }
+
+    QPainter painter(&thumbnail);
+    painter.setCompositionMode(QPainter::CompositionMode_Source); // The page's alpha too
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
+    painter.scale(1.0 / dpr, 1.0 / dpr); // Draw in thumbnail pixels
+    for (const QRect& rect : deviceRegion) {
+        // Whole thumbnail pixels, so a partial update leaves no seams against the old ones
+        const QRect target = QRectF(QPointF(rect.topLeft()) * scale, QSizeF(rect.size()) * scale).toAlignedRect()
+                             & QRect(QPoint(0, 0), thumbnailSize);
+        const QRectF source(QPointF(target.topLeft()) / scale, QSizeF(target.size()) / scale);
+        painter.drawPixmap(QRectF(target), pageRender, source);
+    }
+    painter.end();
+
+    m_unsaved.insert(pageId);
+    if (complete) {
+        m_incomplete.remove(pageId);
+        m_flushTimer->start();
+    } else {
+        m_incomplete.insert(pageId); // The content's arrival invalidates the page and renders again
+    }
+    emit thumbnailChanged(pageId);
+}
@@ -0,0 +1,48 @@
+#ifndef PAGETHUMBNAILCACHE_H
+#define PAGETHUMBNAILCACHE_H
+
+#include <QObject>
+#include <QHash>
+#include <QPixmap>
+#include <QRegion>
+#include <QSet>
+#include <QUuid>
+
+class QTimer;
+class DatabaseManager;
+
+// Small pictures of every page for the page overview. Kept current from each page's render cache
+// renders, where only the rendered rects are scaled down again, and stored in the database so
+// they are there right after a restart. Showing them never renders a page. GUI thread only.
+class PageThumbnailCache : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit PageThumbnailCache(DatabaseManager* dbManager, QObject* parent = nullptr);
+
+    static int thumbnailWidth() { return 240; } // Logical pixels; the height follows the page
+
+    void load(); // From the database, which must be open
+    void flush(); // Writes the thumbnails changed since the last flush
+
+    QPixmap thumbnail(const QUuid& pageId) const { return m_thumbnails.value(pageId); } // Null if never rendered
+    void removePage(const QUuid& pageId);
+
+public slots:
+    // region is in page coordinates; pageRender is the page's full render at its device pixel ratio.
+    // An incomplete render still shows loading placeholders: used, but not stored until complete.
+    void updateFromRender(const QUuid& pageId, const QPixmap& pageRender, const QRegion& region, bool complete);
+
+signals:
+    void thumbnailChanged(const QUuid& pageId);
+
+private:
+    DatabaseManager* m_dbManager;
+    QHash<QUuid, QPixmap> m_thumbnails;
+    QSet<QUuid> m_unsaved;
+    QSet<QUuid> m_incomplete; // Unsaved, and kept so until a complete render replaces the placeholders
+    QTimer* m_flushTimer; // Collects a burst of renders into one write
+};
+
+#endif // PAGETHUMBNAILCACHE_H
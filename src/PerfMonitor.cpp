@@ -0,0 +1,202 @@
+#include "PerfMonitor.h"
+#include <QCoreApplication>
+#include <algorithm>
+
+namespace {
+
+constexpr qint64 FrameWindowMsecs = 5000; // p99 needs a few hundred frames to mean anything
+constexpr int PaintsPerKind = 3;
+constexpr int PaintTimesKept = 20000; // Per kind; icons can paint thousands of times a second
+constexpr int DecodesShown = 3;
+constexpr int SavesKept = 6;
+
+// Keeps the slowest few samples, slowest first
+void insertSlowest(QList<PerfMonitor::PaintSample>& samples, const PerfMonitor::PaintSample& sample)
+{
+    if (samples.size() >= PaintsPerKind && samples.last().nsecs >= sample.nsecs) return;
+    auto pos = std::find_if(samples.begin(), samples.end(), [&sample](const PerfMonitor::PaintSample& s) {
+        return s.nsecs < sample.nsecs;
+    });
+    samples.insert(pos, sample);
+    if (samples.size() > PaintsPerKind) samples.removeLast();
+}
+
+// The value 99% of the samples are at or below; 0 for none
+qint64 percentile99(QList<qint64> values)
+{
+    if (values.isEmpty()) return 0;
+    const int index = qMin<int>(values.size() - 1, int(values.size() * 0.99));
+    std::nth_element(values.begin(), values.begin() + index, values.end());
+    return values.at(index);
+}
+
+}
+
+bool PerfMonitor::s_enabled = false;
+
+PerfMonitor::PerfMonitor(QObject* parent)
+    : QObject(parent)
+{
+    m_clock.start();
+}
+
+PerfMonitor* PerfMonitor::instance()
+{
+    static PerfMonitor* monitor = new PerfMonitor(QCoreApplication::instance());
+    return monitor;
+}
+
+void PerfMonitor::setEnabled(bool enabled)
+{
+    if (enabled && !s_enabled) {
+        instance()->clear(); // Samples from an earlier session would be stale
+    }
+    s_enabled = enabled;
+}
+
+QString PerfMonitor::kindName(PaintKind kind)
+{
+    switch (kind) {
+    case PaintKind::Page: return QStringLiteral("PageTabContentWidget");
+    case PaintKind::Zone: return QStringLiteral("ZoneWidget");
+    case PaintKind::Icon: return QStringLiteral("IconWidget");
+    }
+    return QString();
+}
+
+void PerfMonitor::clear()
+{
+    m_frames.clear();
+    m_currentPaints = PaintBucket();
+    m_previousPaints = PaintBucket();
+    m_currentSecond = -1;
+    for (QList<FrameSample>& paintTimes : m_paintTimes) paintTimes.clear();
+    m_decodes.clear();
+    m_saves.clear();
+}
+
+void PerfMonitor::recordFrame(qint64 nsecs)
+{
+    const qint64 now = m_clock.elapsed();
+    m_frames.append({now, nsecs});
+    while (!m_frames.isEmpty() && now - m_frames.first().atMsecs > FrameWindowMsecs) {
+        m_frames.removeFirst();
+    }
+}
+
+void PerfMonitor::rotatePaintBuckets()
+{
+    const qint64 second = m_clock.elapsed() / 1000;
+    if (second == m_currentSecond) return;
+    m_previousPaints = second == m_currentSecond + 1 ? m_currentPaints : PaintBucket();
+    m_currentPaints = PaintBucket();
+    m_currentSecond = second;
+}
+
+void PerfMonitor::recordPaint(PaintKind kind, const QString& label, qint64 nsecs)
+{
+    rotatePaintBuckets();
+    insertSlowest(m_currentPaints[int(kind)], {kind, label, nsecs});
+
+    const qint64 now = m_clock.elapsed();
+    QList<FrameSample>& paintTimes = m_paintTimes[int(kind)];
+    paintTimes.append({now, nsecs});
+    while (!paintTimes.isEmpty()
+           && (now - paintTimes.first().atMsecs > FrameWindowMsecs || paintTimes.size() > PaintTimesKept)) {
+        paintTimes.removeFirst();
+    }
+}
+
+void PerfMonitor::recordDecode(const QString& path, qint64 decodeNsecs, qint64 processNsecs)
+{
+    const qint64 now = m_clock.elapsed();
+    m_decodes.append({path, decodeNsecs, processNsecs, now});
+    while (!m_decodes.isEmpty() && now - m_decodes.first().atMsecs > FrameWindowMsecs) {
+        m_decodes.removeFirst();
+    }
+}
+
+void PerfMonitor::recordSave(const QString& kind, qint64 nsecs, bool ok)
+{
+    m_saves.append({kind, nsecs, m_clock.elapsed(), ok});
+    if (m_saves.size() > SavesKept) m_saves.removeFirst();
+}
+
+PerfMonitor::Report PerfMonitor::report() const
+{
+    Report report;
+    const qint64 now = m_clock.elapsed();
+
+    QList<qint64> frameTimes;
+    frameTimes.reserve(m_frames.size());
+    for (const FrameSample& frame : m_frames) {
+        if (now - frame.atMsecs <= 1000) ++report.framesPerSecond;
+        if (now - frame.atMsecs <= FrameWindowMsecs) frameTimes.append(frame.nsecs);
+    }
+    if (!frameTimes.isEmpty()) {
+        report.maxFrameNsecs = *std::max_element(frameTimes.begin(), frameTimes.end());
+        report.p99FrameNsecs = percentile99(std::move(frameTimes));
+    }
+
+    QList<qint64> allPaintTimes;
+    for (int kind = 0; kind < PaintKindCount; ++kind) {
+        QList<qint64> paintTimes;
+        for (const FrameSample& paint : m_paintTimes[kind]) {
+            if (now - paint.atMsecs <= FrameWindowMsecs) paintTimes.append(paint.nsecs);
+        }
+        allPaintTimes += paintTimes;
+        report.p99PaintNsecsByKind[kind] = percentile99(std::move(paintTimes));
+    }
+    report.p99PaintNsecs = percentile99(std::move(allPaintTimes));
+
+    QList<qint64> decodeTimes;
+    for (const DecodeSample& decode : m_decodes) {
+        if (now - decode.atMsecs > FrameWindowMsecs) continue;
+        decodeTimes.append(decode.decodeNsecs + decode.processNsecs);
+        auto pos = std::find_if(report.slowestDecodes.begin(), report.slowestDecodes.end(), [&decode](const DecodeSample& d) {
+            return d.decodeNsecs + d.processNsecs < decode.decodeNsecs + decode.processNsecs;
+        });
+        report.slowestDecodes.insert(pos, decode);
+        if (report.slowestDecodes.size() > DecodesShown) report.slowestDecodes.removeLast();
+    }
+    report.decodes = decodeTimes.size();
+    report.p99DecodeNsecs = percentile99(std::move(decodeTimes));
+
+    // The current second and, if it was the one just before, the previous one
+    const qint64 second = now / 1000;
+    for (int kind = 0; kind < PaintKindCount; ++kind) {
+        if (m_currentSecond == second || m_currentSecond == second - 1) {
+            for (const PaintSample& sample : m_currentPaints[kind]) insertSlowest(report.slowestPaints[kind], sample);
+        }
+        if (m_currentSecond == second) {
+            for (const PaintSample& sample : m_previousPaints[kind]) insertSlowest(report.slowestPaints[kind], sample);
+        }
+    }
+
+    for (auto it = m_saves.crbegin(); it != m_saves.crend(); ++it) {
+        report.recentSaves.append(*it);
+    }
+    return report;
+}
+
+PerfMonitor::PaintScope::~PaintScope()
+{
+    if (s_enabled && m_timer.isValid()) {
+        instance()->recordPaint(m_kind, m_label, m_timer.nsecsElapsed());
+    }
+}
+
+PerfMonitor::SaveScope::SaveScope(const QString& kind)
+{
+    if (s_enabled) {
+        m_kind = kind;
+        m_timer.start();
+    }
+}
+
+PerfMonitor::SaveScope::~SaveScope()
+{
+    if (s_enabled && m_timer.isValid()) {
+        instance()->recordSave(m_kind, m_timer.nsecsElapsed(), ok);
+    }
+}
@@ -0,0 +1,122 @@
+#ifndef PERFMONITOR_H
+#define PERFMONITOR_H
+
+#include <QObject>
+#include <QElapsedTimer>
+#include <QList>
+#include <QString>
+#include <array>
+
+// Frame, paint, image decode and database save timings for the performance HUD. Nothing is recorded while the
+// HUD is off: every hook begins with one static flag check. GUI thread only.
+class PerfMonitor : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum class PaintKind { Page, Zone, Icon };
+    static constexpr int PaintKindCount = 3;
+
+    struct PaintSample
+    {
+        PaintKind kind;
+        QString label; // Page name, zone title or icon name
+        qint64 nsecs;
+    };
+    struct DecodeSample
+    {
+        QString path;
+        qint64 decodeNsecs;  // Reading and scaling, on a decode worker
+        qint64 processNsecs; // Format conversion and blur, on the same worker
+        qint64 atMsecs;      // On the monitor's clock, when the result reached the GUI thread
+    };
+    struct SaveSample
+    {
+        QString kind; // "incremental" or "full"
+        qint64 nsecs;
+        qint64 atMsecs; // On the monitor's clock; see msecsSince()
+        bool ok;
+    };
+    struct Report
+    {
+        int framesPerSecond = 0;  // Window frames painted in the last second; 0 while idle
+        qint64 p99FrameNsecs = 0; // Over the last few seconds
+        qint64 maxFrameNsecs = 0;
+        qint64 p99PaintNsecs = 0; // Over every widget paint of the last few seconds
+        std::array<qint64, PaintKindCount> p99PaintNsecsByKind{};
+        std::array<QList<PaintSample>, PaintKindCount> slowestPaints; // Last second, slowest first, per kind
+        int decodes = 0;                 // Finished in the last few seconds
+        qint64 p99DecodeNsecs = 0;       // Decode plus processing
+        QList<DecodeSample> slowestDecodes; // Last few seconds, slowest first
+        QList<SaveSample> recentSaves; // Newest first
+    };
+
+    static PerfMonitor* instance(); // Created on first use on the GUI thread, owned by qApp
+    static bool isEnabled() { return s_enabled; }
+    static void setEnabled(bool enabled); // Turning it on starts from empty samples
+    static QString kindName(PaintKind kind);
+
+    void recordFrame(qint64 nsecs);
+    void recordPaint(PaintKind kind, const QString& label, qint64 nsecs);
+    void recordDecode(const QString& path, qint64 decodeNsecs, qint64 processNsecs);
+    void recordSave(const QString& kind, qint64 nsecs, bool ok);
+    Report report() const;
+    qint64 msecsSince(qint64 atMsecs) const { return m_clock.elapsed() - atMsecs; }
+
+    // Times a paintEvent from construction to destruction. label is a callable returning the
+    // QString to report; it is only called while enabled, so a paint with the HUD off builds nothing.
+    class PaintScope
+    {
+    public:
+        template <typename LabelFn>
+        PaintScope(PaintKind kind, LabelFn&& label)
+            : m_kind(kind)
+        {
+            if (s_enabled) {
+                m_label = label();
+                m_timer.start();
+            }
+        }
+        ~PaintScope();
+    private:
+        PaintKind m_kind;
+        QString m_label;
+        QElapsedTimer m_timer;
+    };
+
+    // Times a database save. Set ok to false on the failure paths.
+    class SaveScope
+    {
+    public:
+        explicit SaveScope(const QString& kind);
+        ~SaveScope();
+        bool ok = true;
+    private:
+        QString m_kind;
+        QElapsedTimer m_timer;
+    };
+
+private:
+    explicit PerfMonitor(QObject* parent = nullptr);
+    void clear();
+    void rotatePaintBuckets(); // Moves to the bucket of the current second
+
+    struct FrameSample
+    {
+        qint64 atMsecs;
+        qint64 nsecs;
+    };
+    using PaintBucket = std::array<QList<PaintSample>, PaintKindCount>; // Top few per kind
+
+    static bool s_enabled;
+    QElapsedTimer m_clock;
+    QList<FrameSample> m_frames;   // Last few seconds, oldest first
+    PaintBucket m_currentPaints;   // This second
+    PaintBucket m_previousPaints;  // The second before, if it was the one just before
+    std::array<QList<FrameSample>, PaintKindCount> m_paintTimes; // Every paint of the last few seconds, for the p99
+    QList<DecodeSample> m_decodes; // Last few seconds, oldest first
+    qint64 m_currentSecond = -1;
+    QList<SaveSample> m_saves;     // Last few, oldest first
+};
+
+#endif // PERFMONITOR_H
@@ -0,0 +1,131 @@
+#include "PerformanceHud.h"
+#include "PerfMonitor.h"
+#include "ImageDecodeService.h"
+#include <QFileInfo>
+#include <QFontDatabase>
+#include <QFontMetrics>
+#include <QPainter>
+#include <QTimer>
+
+namespace {
+
+QString formatMsecs(qint64 nsecs)
+{
+    return QString::number(nsecs / 1e6, 'f', 2) + " ms";
+}
+
+QString formatAge(qint64 msecs)
+{
+    if (msecs < 60 * 1000) return QString("%1 s ago").arg(msecs / 1000);
+    return QString("%1 min ago").arg(msecs / (60 * 1000));
+}
+
+}
+
+PerformanceHud::PerformanceHud(QWidget* anchor)
+    : QWidget(anchor ? anchor->window() : nullptr,
+              Qt::Tool | Qt::FramelessWindowHint | Qt::WindowStaysOnTopHint | Qt::WindowTransparentForInput),
+      m_anchor(anchor)
+{
+    setObjectName("PerformanceHud");
+    setAttribute(Qt::WA_TranslucentBackground);
+    setAttribute(Qt::WA_TransparentForMouseEvents);
+    setAttribute(Qt::WA_ShowWithoutActivating);
+    setFont(QFontDatabase::systemFont(QFontDatabase::FixedFont)); // Columns line up
+
+    m_refreshTimer = new QTimer(this);
+    m_refreshTimer->setInterval(500);
+    connect(m_refreshTimer, &QTimer::timeout, this, &PerformanceHud::refresh);
+}
+
+void PerformanceHud::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    PerfMonitor::setEnabled(true); // Recording only costs while someone is looking
+    refresh();
+    m_refreshTimer->start();
+}
+
+void PerformanceHud::hideEvent(QHideEvent *event)
+{
+    m_refreshTimer->stop();
+    PerfMonitor::setEnabled(false);
+    QWidget::hideEvent(event);
+}
+
+void PerformanceHud::refresh()
+{
+    const PerfMonitor* monitor = PerfMonitor::instance();
+    const PerfMonitor::Report report = monitor->report();
+
+    m_lines.clear();
+    m_lines << QString("%1 fps   p99 frame %2   max %3").arg(report.framesPerSecond)
+                   .arg(formatMsecs(report.p99FrameNsecs), formatMsecs(report.maxFrameNsecs));
+
+    m_lines << QString("p99 paint %1   page %2   zone %3   icon %4").arg(formatMsecs(report.p99PaintNsecs),
+                   formatMsecs(report.p99PaintNsecsByKind[int(PerfMonitor::PaintKind::Page)]),
+                   formatMsecs(report.p99PaintNsecsByKind[int(PerfMonitor::PaintKind::Zone)]),
+                   formatMsecs(report.p99PaintNsecsByKind[int(PerfMonitor::PaintKind::Icon)]));
+
+    m_lines << QString() << "Slowest paints, last second";
+    for (const QList<PerfMonitor::PaintSample>& samples : report.slowestPaints) {
+        for (const PerfMonitor::PaintSample& sample : samples) {
+            m_lines << QString("  %1 %2 %3").arg(PerfMonitor::kindName(sample.kind), -20)
+                           .arg(formatMsecs(sample.nsecs), 10).arg(sample.label.left(32));
+        }
+    }
+
+    const ImageCache::Stats cache = ImageDecodeService::instance()->cache().stats();
+    const quint64 lookups = cache.hits + cache.misses;
+    m_lines << QString() << "Image cache";
+    m_lines << QString("  %1 / %2 MB in %3 images").arg(cache.usedBytes / (1024.0 * 1024.0), 0, 'f', 1)
+                   .arg(cache.budgetBytes / (1024 * 1024)).arg(cache.entries);
+    m_lines << QString("  %1% hits (%2 of %3), %4 evictions").arg(lookups ? 100.0 * cache.hits / lookups : 0.0, 0, 'f', 1)
+                   .arg(cache.hits).arg(lookups).arg(cache.evictions);
+    m_lines << QString("  %1 decodes in 5 s, p99 %2").arg(report.decodes).arg(formatMsecs(report.p99DecodeNsecs));
+    for (const PerfMonitor::DecodeSample& decode : report.slowestDecodes) {
+        m_lines << QString("  decode %1 + process %2  %3").arg(formatMsecs(decode.decodeNsecs), 10)
+                       .arg(formatMsecs(decode.processNsecs), 10).arg(QFileInfo(decode.path).fileName().left(28));
+    }
+
+    m_lines << QString() << "Database saves";
+    if (report.recentSaves.isEmpty()) {
+        m_lines << "  none yet";
+    }
+    for (const PerfMonitor::SaveSample& save : report.recentSaves) {
+        m_lines << QString("  %1 %2 %3%4").arg(save.kind, -12).arg(formatMsecs(save.nsecs), 10)
+                       .arg(formatAge(monitor->msecsSince(save.atMsecs)), save.ok ? QString() : QString("  FAILED"));
+    }
+
+    // Grow to fit, then stay at the anchor's top-right corner
+    const QFontMetrics metrics(font());
+    int textWidth = 0;
+    for (const QString& line : std::as_const(m_lines)) {
+        textWidth = qMax(textWidth, metrics.horizontalAdvance(line));
+    }
+    const QSize panelSize(textWidth + 20, metrics.lineSpacing() * m_lines.size() + 16);
+    if (panelSize != size()) resize(panelSize);
+    if (m_anchor) {
+        const QRect anchorRect(m_anchor->mapToGlobal(QPoint(0, 0)), m_anchor->size());
+        move(anchorRect.right() - width() - 12, anchorRect.top() + 12);
+    }
+    update();
+}
+
+void PerformanceHud::paintEvent(QPaintEvent *event)
+{
+    Q_UNUSED(event);
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(QColor(0, 0, 0, 190));
+    painter.drawRoundedRect(rect(), 8, 8);
+
+    painter.setPen(QColor(120, 255, 140)); // Readable over any wallpaper in a screenshot
+    const QFontMetrics metrics(font());
+    int y = 8 + metrics.ascent();
+    for (const QString& line : std::as_const(m_lines)) {
+        painter.drawText(10, y, line);
+        y += metrics.lineSpacing();
+    }
+}
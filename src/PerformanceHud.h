@@ -0,0 +1,33 @@
+#ifndef PERFORMANCEHUD_H
+#define PERFORMANCEHUD_H
+
+#include <QWidget>
+#include <QStringList>
+
+class QTimer;
+
+// Small always-on-top panel with PerfMonitor's numbers and the image cache statistics, refreshed
+// twice a second. A window of its own, so its repaints are not counted as overlay frames.
+// Mouse events pass through it.
+class PerformanceHud : public QWidget
+{
+    Q_OBJECT
+
+public:
+    explicit PerformanceHud(QWidget* anchor); // Shown at the anchor's top-right corner
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+    void paintEvent(QPaintEvent *event) override;
+
+private slots:
+    void refresh();
+
+private:
+    QWidget* m_anchor;
+    QTimer* m_refreshTimer;
+    QStringList m_lines;
+};
+
+#endif // PERFORMANCEHUD_H
@@ -12,13 +12,13 @@
 #include <QLabel>
 #include <QScrollArea>
 #include <QMenu>
-#include <QFileIconProvider>
+#include "FileIconService.h" // System icons, resolved off the GUI thread
 
 
 const QString PINNED_ITEMS_KEY = "QuickAccessPanel/pinnedItems";
 
 QuickAccessPanel::QuickAccessPanel(QWidget *parent)
-    : QWidget(parent), m_iconProvider(new QFileIconProvider)
+    : QWidget(parent)
 {
     setObjectName("QuickAccessPanel");
     setAcceptDrops(true); // Enable D&D for the whole panel
@@ -29,7 +29,6 @@ QuickAccessPanel::QuickAccessPanel(QWidget *parent)
 QuickAccessPanel::~QuickAccessPanel()
 {
     savePinnedItems(); // Save on destruction (or when panel is hidden/app closes)
-    delete m_iconProvider;
     qDebug() << "QuickAccessPanel destroyed";
 }
 
@@ -115,10 +114,9 @@ void QuickAccessPanel::addFolderShortcut(const QString& name, const QString& pat
     button->setStyleSheet("QPushButton { text-align: left; padding-left: 8px; border: none; background-color: transparent; }"
                           "QPushButton:hover { background-color: rgba(0,0,0,0.05); }");
 
-    QIcon icon = m_iconProvider->icon(QFileInfo(path));
-    if(icon.isNull()) icon = style()->standardIcon(QStyle::SP_DirIcon);
-    button->setIcon(icon);
+    button->setIcon(style()->standardIcon(QStyle::SP_DirIcon)); // Until the system icon is resolved
     button->setIconSize(QSize(16,16));
+    requestFileIcon(button, path);
 
     connect(button, &QPushButton::clicked, this, &QuickAccessPanel::onFolderButtonClicked);
     m_folderButtonToPathMap.insert(button, path);
@@ -173,8 +171,9 @@ void QuickAccessPanel::createPinnedItemButton(const QString& path) {
     QToolButton* button = new QToolButton(m_pinnedItemsContainer);
     button->setText(fileInfo.fileName().isEmpty() ? path : fileInfo.fileName()); // Show full path if no filename
     button->setToolTip(path);
-    button->setIcon(m_iconProvider->icon(fileInfo));
+    button->setIcon(style()->standardIcon(QStyle::SP_FileIcon)); // Until the system icon is resolved
     button->setIconSize(QSize(16, 16));
+    requestFileIcon(button, path);
     button->setToolButtonStyle(Qt::ToolButtonTextBesideIcon);
     button->setFixedHeight(28);
     button->setFocusPolicy(Qt::NoFocus);
@@ -198,6 +197,15 @@ void QuickAccessPanel::createPinnedItemButton(const QString& path) {
     m_pinnedItemsLayout->addWidget(button);
 }
 
+void QuickAccessPanel::requestFileIcon(QAbstractButton* button, const QString& path) {
+    // The button is the receiver: one deleted before the icon arrives is simply skipped
+    FileIconService::instance()->subscribe(path, button->iconSize(), devicePixelRatioF(), button, [button](const QPixmap& icon) {
+        if (!icon.isNull()) {
+            button->setIcon(QIcon(icon));
+        }
+    });
+}
+
 QWidget* QuickAccessPanel::findPinnedButtonByPath(const QString& path) {
     for (int i = 0; i < m_pinnedItemsLayout->count(); ++i) {
         QWidget* widget = m_pinnedItemsLayout->itemAt(i)->widget();
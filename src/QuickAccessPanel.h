@@ -9,11 +9,11 @@
 #include <QMimeData>
 
 class QPushButton;
+class QAbstractButton;
 class QToolButton; // For pinned items
 class QVBoxLayout;
 class QScrollArea; // To make pinned items scrollable
 class QLabel;      // For section headers
-#include <QFileIconProvider> // To get system icons (member variable)
 
 class QuickAccessPanel : public QWidget
 {
@@ -40,6 +40,7 @@ private:
     void savePinnedItems();
     void addPinnedItem(const QString& path, bool fromLoad = false);
     void createPinnedItemButton(const QString& path);
+    void requestFileIcon(QAbstractButton* button, const QString& path); // Placeholder now, system icon when resolved
     QWidget* findPinnedButtonByPath(const QString& path);
 
 
@@ -51,7 +52,6 @@ private:
     QWidget* m_pinnedItemsContainer;  // Widget holding m_pinnedItemsLayout, put into scrollArea
     QScrollArea* m_pinnedItemsScrollArea;
     QStringList m_pinnedItemPaths;     // List of paths for pinned items
-    QFileIconProvider* m_iconProvider; // For fetching system icons
 };
 
 #endif // QUICKACCESSPANEL_H
@@ -0,0 +1,140 @@
+#include "ShadowPainter.h"
+#include "BlurEngine.h"
+#include <QHash>
+#include <QImage>
+#include <QPainter>
+#include <QPainterPath>
+#include <QPixmap>
+#include <QDebug>
+#include "Logging.h"
+#include <QtMath>
+
+namespace {
+
+struct NinePatch
+{
+    QPixmap pixmap; // Square, 2 * corner + 1 device pixels a side; the middle row and column stretch
+    int corner = 0; // Device pixels
+};
+
+struct NinePatchKey
+{
+    int blurRadius;
+    QRgb rgba;
+    qreal cornerRadius;
+    qreal dpr;
+
+    bool operator==(const NinePatchKey& other) const
+    {
+        return blurRadius == other.blurRadius && rgba == other.rgba && cornerRadius == other.cornerRadius
+               && dpr == other.dpr;
+    }
+};
+
+size_t qHash(const NinePatchKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.blurRadius, key.rgba, key.cornerRadius, key.dpr);
+}
+
+QHash<NinePatchKey, NinePatch>& ninePatches()
+{
+    static QHash<NinePatchKey, NinePatch> cache; // A handful of styles; never large
+    return cache;
+}
+
+// The blurred shadow of a body whose straight edges are one pixel long. A body of any size is
+// this image with the middle row and column stretched.
+NinePatch buildNinePatch(int blurRadius, const QColor& color, qreal cornerRadius, qreal dpr)
+{
+    const int extent = qCeil(blurRadius * dpr);              // Blur reach past the body
+    const int radius = qCeil(qMax<qreal>(0, cornerRadius) * dpr);
+    NinePatch patch;
+    patch.corner = radius + 2 * extent; // Past this the blur only varies across an edge, not along it
+    const int side = 2 * patch.corner + 1;
+
+    QImage image(side, side, QImage::Format_ARGB32_Premultiplied);
+    image.fill(Qt::transparent);
+    {
+        QPainter painter(&image);
+        painter.setRenderHint(QPainter::Antialiasing);
+        painter.setPen(Qt::NoPen);
+        painter.setBrush(color);
+        painter.drawRoundedRect(QRectF(extent, extent, side - 2 * extent, side - 2 * extent), radius, radius);
+    }
+    // Three box passes of this radius reach about 3 sigma, i.e. the extent
+    const int boxRadius = BlurEngine::boxRadiusForSigma(extent / 3.0);
+    BlurEngine::blur(image, boxRadius, boxRadius);
+
+    patch.pixmap = QPixmap::fromImage(image);
+    patch.pixmap.setDevicePixelRatio(dpr);
+    return patch;
+}
+
+}
+
+namespace ShadowPainter
+{
+
+QMargins margins(const Shadow& shadow)
+{
+    const int extent = shadow.blurRadius;
+    return QMargins(qMax(0, extent - shadow.offset.x()), qMax(0, extent - shadow.offset.y()),
+                    qMax(0, extent + shadow.offset.x()), qMax(0, extent + shadow.offset.y()));
+}
+
+void paint(QPainter* painter, const QRect& bodyRect, qreal cornerRadius, const Shadow& shadow, const QRegion& exposed,
+           bool opaqueBody)
+{
+    if (!painter || bodyRect.isEmpty() || shadow.color.alpha() == 0) return;
+    // Most page repaints are a dragged icon or two; most shadows are nowhere near them
+    if (!exposed.isEmpty() && !exposed.intersects(bodyRect.marginsAdded(margins(shadow)))) return;
+
+    const qreal dpr = painter->device() ? painter->device()->devicePixelRatioF() : 1.0;
+    const NinePatchKey key{shadow.blurRadius, shadow.color.rgba(), cornerRadius, dpr};
+    auto it = ninePatches().constFind(key);
+    if (it == ninePatches().constEnd()) {
+        it = ninePatches().insert(key, buildNinePatch(shadow.blurRadius, shadow.color, cornerRadius, dpr));
+        qCDebug(lcImage) << "Built shadow nine-patch" << shadow.blurRadius << shadow.color << cornerRadius << "@" << dpr
+                         << it->pixmap.size();
+    }
+    const NinePatch& patch = it.value();
+
+    const QRectF target = QRectF(bodyRect.translated(shadow.offset))
+                              .adjusted(-shadow.blurRadius, -shadow.blurRadius, shadow.blurRadius, shadow.blurRadius);
+    // A body smaller than two corners gets its corners squeezed instead of overlapping
+    const qreal corner = patch.corner / dpr;
+    const qreal cornerX = qMin(corner, target.width() / 2);
+    const qreal cornerY = qMin(corner, target.height() / 2);
+    const qreal targetX[4] = {target.left(), target.left() + cornerX, target.right() - cornerX, target.right()};
+    const qreal targetY[4] = {target.top(), target.top() + cornerY, target.bottom() - cornerY, target.bottom()};
+    const qreal source[4] = {0, qreal(patch.corner), qreal(patch.corner + 1), qreal(2 * patch.corner + 1)}; // Device pixels
+
+    // Keep the shadow out from under a translucent body, or it shows through as a dark blob.
+    // An opaque body covers it anyway, so it is not worth a path clip.
+    painter->save();
+    if (!opaqueBody) {
+        QPainterPath outside;
+        outside.addRect(target);
+        QPainterPath body;
+        body.addRoundedRect(QRectF(bodyRect), cornerRadius, cornerRadius);
+        painter->setClipPath(outside.subtracted(body), Qt::IntersectClip);
+    }
+
+    for (int row = 0; row < 3; ++row) {
+        for (int column = 0; column < 3; ++column) {
+            const QRectF pieceTarget(QPointF(targetX[column], targetY[row]), QPointF(targetX[column + 1], targetY[row + 1]));
+            if (pieceTarget.isEmpty()) continue;
+            if (!exposed.isEmpty() && !exposed.intersects(pieceTarget.toAlignedRect())) continue;
+            const QRectF pieceSource(QPointF(source[column], source[row]), QPointF(source[column + 1], source[row + 1]));
+            painter->drawPixmap(pieceTarget, patch.pixmap, pieceSource);
+        }
+    }
+    painter->restore();
+}
+
+void clear()
+{
+    ninePatches().clear();
+}
+
+}
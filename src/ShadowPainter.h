@@ -0,0 +1,35 @@
+#ifndef SHADOWPAINTER_H
+#define SHADOWPAINTER_H
+
+#include <QColor>
+#include <QMargins>
+#include <QPoint>
+#include <QRect>
+#include <QRegion>
+
+class QPainter;
+
+// Soft drop shadows for rounded rectangles, drawn from a blurred nine-patch instead of blurring
+// the widget on every repaint the way QGraphicsDropShadowEffect does. The nine-patch is built
+// with BlurEngine once per (blur radius, color, corner radius, device pixel ratio); the offset
+// only moves it. Painting is at most nine pixmap blits. GUI thread only.
+namespace ShadowPainter
+{
+    struct Shadow {
+        int blurRadius; // How far the shadow fades out past the body, in logical pixels
+        QColor color;
+        QPoint offset;
+    };
+
+    QMargins margins(const Shadow& shadow); // How far the shadow reaches past each side of the body
+
+    // Draws the shadow of bodyRect, a rectangle with corners of cornerRadius, in the painter's
+    // coordinates. Pieces outside exposed are skipped; an empty exposed draws all of them. Unless the
+    // caller says the body is opaque, nothing is drawn inside the body, so translucent bodies don't darken.
+    void paint(QPainter* painter, const QRect& bodyRect, qreal cornerRadius, const Shadow& shadow,
+               const QRegion& exposed = QRegion(), bool opaqueBody = false);
+
+    void clear(); // Drops every cached nine-patch
+}
+
+#endif // SHADOWPAINTER_H
@@ -0,0 +1,95 @@
+#include "StaticTextCache.h"
+#include <QCache>
+#include <QFontMetrics>
+#include <QStringList>
+#include <QTextLayout>
+#include <QTextOption>
+#include <QTransform>
+
+namespace {
+
+struct TextKey
+{
+    QString text;
+    QFont font;
+    int width;
+    int maxLines;
+    int mode;
+    int alignment;
+
+    bool operator==(const TextKey& other) const
+    {
+        return width == other.width && maxLines == other.maxLines && mode == other.mode
+               && alignment == other.alignment && text == other.text && font == other.font;
+    }
+};
+
+size_t qHash(const TextKey& key, size_t seed = 0)
+{
+    return qHashMulti(seed, key.text, key.font, key.width, key.maxLines, key.mode, key.alignment);
+}
+
+QCache<TextKey, QStaticText>& textCache()
+{
+    static QCache<TextKey, QStaticText> cache(4096); // Entries; each is a few glyph runs
+    return cache;
+}
+
+// Breaks text into lines as wide as width and elides whatever does not fit in the last one.
+// Lines are joined with U+2028 so QStaticText keeps exactly these breaks.
+QString elideToLines(const QString& text, const QFont& font, int width, int maxLines, Qt::TextElideMode mode)
+{
+    const QFontMetrics metrics(font);
+    if (maxLines <= 1 || metrics.horizontalAdvance(text) <= width) {
+        return metrics.elidedText(text, mode, width);
+    }
+
+    QTextLayout layout(text, font);
+    QTextOption option;
+    option.setWrapMode(QTextOption::WrapAtWordBoundaryOrAnywhere); // File names often have no spaces
+    layout.setTextOption(option);
+
+    QStringList lines;
+    int consumed = 0;
+    layout.beginLayout();
+    while (lines.size() < maxLines - 1) {
+        QTextLine line = layout.createLine();
+        if (!line.isValid()) break;
+        line.setLineWidth(width);
+        lines.append(text.mid(line.textStart(), line.textLength()).trimmed());
+        consumed = line.textStart() + line.textLength();
+    }
+    layout.endLayout();
+
+    if (consumed < text.size()) {
+        // Middle elision of the rest keeps the end of the name, usually the extension, readable
+        lines.append(metrics.elidedText(text.mid(consumed).trimmed(), mode, width));
+    }
+    return lines.join(QChar::LineSeparator);
+}
+
+}
+
+QStaticText StaticTextCache::text(const QString& text, const QFont& font, int width, int maxLines,
+                                  Qt::TextElideMode mode, Qt::Alignment alignment)
+{
+    const TextKey key{text, font, qMax(1, width), qMax(1, maxLines), int(mode), int(alignment)};
+    if (QStaticText* cached = textCache().object(key)) {
+        return *cached; // Implicitly shared; the layout is not copied
+    }
+
+    QStaticText* staticText = new QStaticText(elideToLines(text, font, key.width, key.maxLines, mode));
+    staticText->setTextFormat(Qt::PlainText); // A file named "<b>.txt" is not markup
+    staticText->setTextWidth(key.width);
+    staticText->setTextOption(QTextOption(alignment));
+    staticText->setPerformanceHint(QStaticText::AggressiveCaching);
+    staticText->prepare(QTransform(), font);
+    const QStaticText result = *staticText;
+    textCache().insert(key, staticText); // The cache owns it
+    return result;
+}
+
+void StaticTextCache::clear()
+{
+    textCache().clear();
+}
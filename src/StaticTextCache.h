@@ -0,0 +1,23 @@
+#ifndef STATICTEXTCACHE_H
+#define STATICTEXTCACHE_H
+
+#include <QFont>
+#include <QStaticText>
+#include <QString>
+
+// Pre-laid-out, elided text for labels that are painted over and over: icon captions and zone
+// titles. Each (text, font, width, lines, elide mode) is shaped once into a QStaticText and then
+// drawn from its cached glyphs. A renamed item simply asks for a new key; the old one ages out.
+// GUI thread only.
+namespace StaticTextCache
+{
+    // text wrapped at word boundaries into at most maxLines lines of width pixels, the last line
+    // elided with mode, and centered horizontally when alignment asks for it. Draw it with the
+    // painter's font set to font, or QPainter lays it out again.
+    QStaticText text(const QString& text, const QFont& font, int width, int maxLines,
+                     Qt::TextElideMode mode, Qt::Alignment alignment = Qt::AlignLeft);
+
+    void clear(); // After a theme change, which may change fonts behind the same keys
+}
+
+#endif // STATICTEXTCACHE_H
@@ -3,6 +3,7 @@
 #include <QSettings>
 #include <QStyle>
 #include <QDebug>
+#include "StaticTextCache.h" // Cleared when fonts may change
 
 namespace ThemeManager {
 
@@ -42,6 +43,7 @@ namespace ThemeManager {
         s_currentTheme = theme; // Ensure static variable is also set
         QString styleSheet = currentThemeStylesheet();
         qApp->setStyleSheet(styleSheet);
+        StaticTextCache::clear(); // Captions were laid out with the old theme's fonts
         qDebug() << "Applied theme:" << (theme == Theme::Dark ? "Dark" : "Light");
 
         // Optionally, to force re-polish of all widgets if some styles don't update:
@@ -4,20 +4,24 @@
 #include <QApplication> // For screen geometry if needed later
 #include <QScreen>      // For screen geometry if needed later
 #include <QDebug>
-#include <QGraphicsDropShadowEffect> // For drop shadow
+#include <QPainter>
+#include <QPaintEvent>
+
+namespace {
+
+constexpr qreal BODY_RADIUS = 6;
+
+}
 
 WidgetHostWindow::WidgetHostWindow(QWidget *parent)
     : QWidget(parent, Qt::FramelessWindowHint | Qt::Tool | Qt::WindowStaysOnTopHint),
       m_isDragging(false), m_contentWidget(nullptr)
 {
-    setAttribute(Qt::WA_TranslucentBackground); // Required for shadow to look right if window itself has a fill
+    setAttribute(Qt::WA_TranslucentBackground); // The shadow margins stay see-through
 
-    // Add drop shadow effect
-    QGraphicsDropShadowEffect* shadowEffect = new QGraphicsDropShadowEffect(this);
-    shadowEffect->setBlurRadius(18);
-    shadowEffect->setColor(QColor(0, 0, 0, 80));
-    shadowEffect->setOffset(3, 3);
-    setGraphicsEffect(shadowEffect);
+    // The shadow is painted from a pre-blurred nine-patch around the body, not by a graphics
+    // effect, so a content repaint (the clock's, every second) never blurs anything
+    setContentsMargins(shadowMargins());
 
     // It's often good for these kinds of windows to delete themselves when closed.
     // setAttribute(Qt::WA_DeleteOnClose); // Can be set by user of this class if desired
@@ -31,6 +35,26 @@ WidgetHostWindow::~WidgetHostWindow()
     qDebug() << "WidgetHostWindow destroyed.";
 }
 
+ShadowPainter::Shadow WidgetHostWindow::shadow()
+{
+    return {18, QColor(0, 0, 0, 80), QPoint(3, 3)};
+}
+
+void WidgetHostWindow::paintEvent(QPaintEvent *event)
+{
+    QPainter painter(this);
+    const QRect body = contentsRect();
+    // A content repaint inside the body exposes the middle piece at most
+    ShadowPainter::paint(&painter, body, BODY_RADIUS, shadow(), event->region());
+
+    // Contrasts with the theme's text color, which the style sheet puts in the palette
+    const bool lightText = palette().color(QPalette::WindowText).lightness() > 128;
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setPen(Qt::NoPen);
+    painter.setBrush(lightText ? QColor(40, 40, 40, 235) : QColor(248, 248, 248, 235));
+    painter.drawRoundedRect(QRectF(body), BODY_RADIUS, BODY_RADIUS);
+}
+
 void WidgetHostWindow::setContentWidget(QWidget* content)
 {
     if (m_contentWidget && m_contentWidget->layout() == layout()) {
@@ -113,6 +137,7 @@ bool WidgetHostWindow::isPointDraggable(const QPoint& pos)
     // By default, the entire window is draggable if no child widget at 'pos' accepts the event.
     // Qt's event propagation usually handles this: if a child accepts the press, this won't be called.
     // However, explicitly checking can be useful.
+    if (!contentsRect().contains(pos)) return false; // The shadow margins are not part of the window
     QWidget* child = childAt(pos);
     if (child && child != m_contentWidget && child->testAttribute(Qt::WA_TransparentForMouseEvents)) {
          // If child is transparent for mouse events, consider it draggable
@@ -3,6 +3,7 @@
 
 #include <QWidget>
 #include <QPoint>
+#include "ShadowPainter.h"
 
 class WidgetHostWindow : public QWidget
 {
@@ -15,7 +16,14 @@ public:
     // Allow setting a central widget or managing a layout directly
     void setContentWidget(QWidget* content);
 
+    // The window is larger than its body by these margins, which hold the shadow. Layouts
+    // inside the window stay within the body, since they are the window's contents margins.
+    static QMargins shadowMargins() { return ShadowPainter::margins(shadow()); }
+
 protected:
+    static ShadowPainter::Shadow shadow();
+
+    void paintEvent(QPaintEvent *event) override; // Shadow and rounded body; the content paints on top
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
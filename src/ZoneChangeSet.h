@@ -0,0 +1,146 @@
+#ifndef ZONECHANGESET_H
+#define ZONECHANGESET_H
+
+#include <QList>
+#include <QSet>
+#include <QHash>
+#include <QUuid>
+#include <QFlags>
+
+class ZoneData; // Forward declaration
+
+// Net effect of one or more edits to a single zone, as collected by a PageManager batch.
+// Icon lists are merged as edits arrive: an icon added and then moved is only "added"
+// (its row carries the final position), and an icon added and then removed disappears entirely.
+// Membership is tracked in hash sets so merging stays linear in the number of notified ids.
+struct ZoneChangeSet
+{
+    enum Change {
+        NoChange       = 0x0,
+        GeometryChange = 0x1,
+        StyleChange    = 0x2,
+        TitleChange    = 0x4,
+        StacksChange   = 0x8  // Stack added, removed, renamed, moved or membership changed
+    };
+    Q_DECLARE_FLAGS(Changes, Change)
+
+    // An icon that arrived from another zone. Its IconData (and widget) moved rather than being recreated.
+    struct Transfer
+    {
+        QUuid iconId;
+        ZoneData* fromZone;
+    };
+
+    ZoneData* zone = nullptr;
+    Changes changes = NoChange;
+    // Filled in first-touched order while merging; may hold stale or repeated ids until finalize()
+    QList<QUuid> movedIconIds;
+    QList<QUuid> addedIconIds;
+    QList<QUuid> removedIconIds;
+    QList<Transfer> transfersIn; // Saved like additions (the row is rewritten with this zone)
+
+    bool isEmpty() const
+    {
+        return changes == NoChange && m_moved.isEmpty() && m_added.isEmpty() && m_removed.isEmpty()
+               && m_transfers.isEmpty();
+    }
+
+    // The zone an icon arrived from in this batch, or nullptr
+    ZoneData* transferSource(const QUuid& iconId) const
+    {
+        return m_transfers.value(iconId, nullptr);
+    }
+
+    void addTransfer(const QUuid& iconId, ZoneData* fromZone)
+    {
+        m_transfers.insert(iconId, fromZone);
+        transfersIn.append({iconId, fromZone});
+    }
+
+    // Returns the zone the icon came from, or nullptr if it did not arrive in this batch
+    ZoneData* takeTransfer(const QUuid& iconId)
+    {
+        return m_transfers.take(iconId);
+    }
+
+    void mergeMoved(const QList<QUuid>& iconIds)
+    {
+        for (const QUuid& id : iconIds) {
+            if (!m_added.contains(id) && !m_moved.contains(id) && !m_transfers.contains(id)) {
+                m_moved.insert(id);
+                movedIconIds.append(id);
+            }
+        }
+    }
+
+    // Icons that left for another zone: nothing to save here, the target rewrites their rows
+    void mergeTransferredOut(const QList<QUuid>& iconIds)
+    {
+        for (const QUuid& id : iconIds) {
+            m_moved.remove(id);
+            m_added.remove(id);
+        }
+    }
+
+    void mergeAdded(const QList<QUuid>& iconIds)
+    {
+        for (const QUuid& id : iconIds) {
+            if (m_removed.remove(id)) {
+                // Removed and put back within the same batch: the row still exists, only its position may differ
+                if (!m_moved.contains(id)) {
+                    m_moved.insert(id);
+                    movedIconIds.append(id);
+                }
+            } else if (!m_added.contains(id)) {
+                m_added.insert(id);
+                addedIconIds.append(id);
+            }
+        }
+    }
+
+    void mergeRemoved(const QList<QUuid>& iconIds)
+    {
+        for (const QUuid& id : iconIds) {
+            m_moved.remove(id);
+            if (!m_added.remove(id) && !m_removed.contains(id)) {
+                m_removed.insert(id); // Only report removals of icons that existed before the batch
+                removedIconIds.append(id);
+            }
+        }
+    }
+
+    // Drops ids that a later merge took back out of a list, keeping the first-touched order.
+    // Called once when the batch commits, so merging itself never scans the lists.
+    void finalize()
+    {
+        compact(movedIconIds, m_moved);
+        compact(addedIconIds, m_added);
+        compact(removedIconIds, m_removed);
+
+        QSet<QUuid> seen;
+        transfersIn.removeIf([this, &seen](const Transfer& transfer) {
+            if (transferSource(transfer.iconId) != transfer.fromZone || seen.contains(transfer.iconId)) return true;
+            seen.insert(transfer.iconId);
+            return false;
+        });
+    }
+
+private:
+    static void compact(QList<QUuid>& ids, const QSet<QUuid>& live)
+    {
+        QSet<QUuid> seen;
+        ids.removeIf([&live, &seen](const QUuid& id) {
+            if (!live.contains(id) || seen.contains(id)) return true;
+            seen.insert(id);
+            return false;
+        });
+    }
+
+    QSet<QUuid> m_moved;
+    QSet<QUuid> m_added;
+    QSet<QUuid> m_removed;
+    QHash<QUuid, ZoneData*> m_transfers;
+};
+Q_DECLARE_OPERATORS_FOR_FLAGS(ZoneChangeSet::Changes)
+
+#endif // ZONECHANGESET_H
@@ -1,12 +1,14 @@
 #include "ZoneData.h"
 #include "IconData.h" // Required for IconData definition
+#include "IconStackData.h"
 #include <QDebug>
+#include "Logging.h"
 
 ZoneData::ZoneData(const QString& title, const QRectF& geometry, const QColor& backgroundColor)
     : m_id(QUuid::createUuid()), m_title(title), m_geometry(geometry),
       m_backgroundColor(backgroundColor), m_cornerRadius(0), m_blurBackgroundImage(false) // Defaults
 {
-    qDebug() << "ZoneData created (new UUID):" << m_id << title;
+    qCDebug(lcZone) << "ZoneData created (new UUID):" << m_id << title;
 }
 
 // Main constructor used for loading from DB
@@ -16,35 +18,40 @@ ZoneData::ZoneData(QUuid id, const QString& title, const QRectF& geometry, const
       m_backgroundColor(backgroundColor), m_cornerRadius(cornerRadius),
       m_backgroundImagePath(bgImagePath), m_blurBackgroundImage(blurBgImage)
 {
-    qDebug() << "ZoneData created (from DB data):" << m_id << title << "Radius:" << cornerRadius << "Img:" << bgImagePath;
+    qCDebug(lcZone) << "ZoneData created (from DB data):" << m_id << title << "Radius:" << cornerRadius << "Img:" << bgImagePath;
 }
 
 
 ZoneData::~ZoneData()
 {
-    qDebug() << "ZoneData destroyed:" << m_id << m_title << "Clearing" << m_icons.count() << "icons.";
+    qCDebug(lcZone) << "ZoneData destroyed:" << m_id << m_title << "Clearing" << m_icons.count() << "icons.";
     // Delete all IconData objects this zone owns
     qDeleteAll(m_icons);
     m_icons.clear();
+    m_iconIndex.clear();
+    qDeleteAll(m_stacks);
+    m_stacks.clear();
 }
 
 void ZoneData::addIcon(IconData* icon)
 {
-    if (icon && !m_icons.contains(icon)) {
+    if (icon && !m_iconIndex.contains(icon->id())) {
         m_icons.append(icon);
-        qDebug() << "Icon" << icon->id() << "added to zone" << m_id;
+        m_iconIndex.insert(icon->id(), icon);
+        invalidateSnapshot();
+        qCDebug(lcZone) << "Icon" << icon->id() << "added to zone" << m_id;
     }
 }
 
 bool ZoneData::removeIcon(const QUuid& iconId)
 {
-    for (int i = 0; i < m_icons.size(); ++i) {
-        if (m_icons.at(i) && m_icons.at(i)->id() == iconId) {
-            IconData* iconToRemove = m_icons.takeAt(i);
-            delete iconToRemove; // ZoneData owns its IconData objects
-            qDebug() << "Icon" << iconId << "removed from zone" << m_id;
-            return true;
-        }
+    IconData* iconToRemove = m_iconIndex.take(iconId);
+    if (iconToRemove) {
+        m_icons.removeOne(iconToRemove);
+        invalidateSnapshot();
+        delete iconToRemove; // ZoneData owns its IconData objects
+        qCDebug(lcZone) << "Icon" << iconId << "removed from zone" << m_id;
+        return true;
     }
     qWarning() << "Icon" << iconId << "not found in zone" << m_id << "for removal.";
     return false;
@@ -52,10 +59,113 @@ bool ZoneData::removeIcon(const QUuid& iconId)
 
 IconData* ZoneData::findIcon(const QUuid& iconId) const
 {
-    for (IconData* icon : m_icons) {
-        if (icon && icon->id() == iconId) {
-            return icon;
+    return m_iconIndex.value(iconId, nullptr);
+}
+
+IconData* ZoneData::takeIcon(const QUuid& iconId)
+{
+    IconData* icon = m_iconIndex.take(iconId);
+    if (icon) {
+        m_icons.removeOne(icon);
+        invalidateSnapshot();
+    }
+    return icon;
+}
+
+void ZoneData::addStack(IconStackData* stack)
+{
+    if (stack && !m_stacks.contains(stack)) {
+        m_stacks.append(stack);
+        invalidateSnapshot();
+    }
+}
+
+IconStackData* ZoneData::takeStack(const QUuid& stackId)
+{
+    for (int i = 0; i < m_stacks.size(); ++i) {
+        if (m_stacks.at(i)->id() == stackId) {
+            invalidateSnapshot();
+            return m_stacks.takeAt(i);
         }
     }
     return nullptr;
 }
+
+IconStackData* ZoneData::findStack(const QUuid& stackId) const
+{
+    for (IconStackData* stack : m_stacks) {
+        if (stack->id() == stackId) {
+            return stack;
+        }
+    }
+    return nullptr;
+}
+
+IconStackData* ZoneData::collapseIcons(const QList<QUuid>& iconIds, const QString& title)
+{
+    IconStackData* stack = nullptr;
+    for (const QUuid& iconId : iconIds) {
+        IconData* icon = takeIcon(iconId);
+        if (!icon) continue;
+        if (!stack) {
+            stack = new IconStackData(title, icon->positionInZone()); // Tile takes the first icon's place
+        }
+        stack->addIcon(icon);
+    }
+    if (stack) {
+        addStack(stack);
+        qCDebug(lcZone) << "Collapsed" << stack->count() << "icons into stack" << stack->id() << "in zone" << m_id;
+    }
+    return stack;
+}
+
+QList<QUuid> ZoneData::ungroupStack(const QUuid& stackId)
+{
+    QList<QUuid> releasedIds;
+    IconStackData* stack = takeStack(stackId);
+    if (!stack) {
+        qWarning() << "Stack" << stackId << "not found in zone" << m_id << "for ungrouping.";
+        return releasedIds;
+    }
+    // Icons keep the position they had before they were stacked
+    while (!stack->icons().isEmpty()) {
+        IconData* icon = stack->takeIcon(stack->icons().first()->id());
+        addIcon(icon);
+        releasedIds.append(icon->id());
+    }
+    delete stack;
+    return releasedIds;
+}
+
+ZoneSnapshot ZoneData::snapshot() const
+{
+    if (m_snapshotValid) {
+        return m_snapshot; // Shares the data, no copy
+    }
+
+    ZoneSnapshotData* data = new ZoneSnapshotData;
+    data->id = m_id;
+    data->pageId = m_pageId;
+    data->title = m_title;
+    data->geometry = m_geometry;
+    data->backgroundColor = m_backgroundColor;
+    data->cornerRadius = m_cornerRadius;
+    data->backgroundImagePath = m_backgroundImagePath;
+    data->blurBackgroundImage = m_blurBackgroundImage;
+    data->icons.reserve(m_icons.size());
+    for (const IconData* icon : m_icons) {
+        data->icons.append({icon->id(), icon->filePath(), icon->positionInZone()}); // filePath shares the interned string
+    }
+    data->stacks.reserve(m_stacks.size());
+    for (const IconStackData* stack : m_stacks) {
+        IconStackSnapshot stackSnapshot{stack->id(), stack->title(), stack->positionInZone(), {}};
+        stackSnapshot.icons.reserve(stack->count());
+        for (const IconData* icon : stack->icons()) {
+            stackSnapshot.icons.append({icon->id(), icon->filePath(), icon->positionInZone()});
+        }
+        data->stacks.append(stackSnapshot);
+    }
+    m_snapshot = ZoneSnapshot(data);
+    m_snapshotValid = true;
+    return m_snapshot;
+}
@@ -6,10 +6,13 @@
 #include <QColor>
 #include <QUuid>
 #include <QList>
+#include <QHash>
+#include "LayoutSnapshot.h"
 
 // Forward declaration for IconData - will be used later
 // struct IconData;
 class IconData; // Forward declaration
+class IconStackData; // Forward declaration
 
 class ZoneData
 {
@@ -21,6 +24,7 @@ public:
     ~ZoneData(); // Destructor to clean up IconData objects
 
     QUuid id() const { return m_id; }
+    QUuid pageId() const { return m_pageId; } // Owning page; set by PageData::addZone, null while unowned
     QString title() const { return m_title; }
     QRectF geometry() const { return m_geometry; }
     QColor backgroundColor() const { return m_backgroundColor; }
@@ -28,23 +32,41 @@ public:
     QString backgroundImagePath() const { return m_backgroundImagePath; }
     bool blurBackgroundImage() const { return m_blurBackgroundImage; }
 
-    void setTitle(const QString& title) { m_title = title; }
-    void setGeometry(const QRectF& geometry) { m_geometry = geometry; }
-    void setBackgroundColor(const QColor& color) { m_backgroundColor = color; }
-    void setCornerRadius(int radius) { m_cornerRadius = qMax(0, radius); } // Ensure non-negative
-    void setBackgroundImagePath(const QString& path) { m_backgroundImagePath = path; }
-    void setBlurBackgroundImage(bool blur) { m_blurBackgroundImage = blur; }
+    void setTitle(const QString& title) { m_title = title; invalidateSnapshot(); }
+    void setGeometry(const QRectF& geometry) { m_geometry = geometry; invalidateSnapshot(); }
+    void setBackgroundColor(const QColor& color) { m_backgroundColor = color; invalidateSnapshot(); }
+    void setCornerRadius(int radius) { m_cornerRadius = qMax(0, radius); invalidateSnapshot(); } // Ensure non-negative
+    void setBackgroundImagePath(const QString& path) { m_backgroundImagePath = path; invalidateSnapshot(); }
+    void setBlurBackgroundImage(bool blur) { m_blurBackgroundImage = blur; invalidateSnapshot(); }
 
     const QList<IconData*>& icons() const { return m_icons; }
     void addIcon(IconData* icon);
     bool removeIcon(const QUuid& iconId);
-    IconData* findIcon(const QUuid& iconId) const;
+    IconData* findIcon(const QUuid& iconId) const; // O(1) via m_iconIndex; loose icons only
+    IconData* takeIcon(const QUuid& iconId); // Removes without deleting; caller takes ownership
+
+    // Icon stacks. Stacked icons are owned by their stack and are not part of icons().
+    const QList<IconStackData*>& stacks() const { return m_stacks; }
+    void addStack(IconStackData* stack); // Takes ownership
+    IconStackData* takeStack(const QUuid& stackId); // Releases ownership
+    IconStackData* findStack(const QUuid& stackId) const;
+    // Moves the given loose icons into a new stack placed at the first icon's position
+    IconStackData* collapseIcons(const QList<QUuid>& iconIds, const QString& title);
+    // Moves every icon of the stack back to the loose icons and deletes the stack. Returns their IDs.
+    QList<QUuid> ungroupStack(const QUuid& stackId);
+
+    // Immutable copy of this zone, rebuilt only after a change. Icon positions are edited
+    // through IconData directly, so PageManager's notify*() also invalidates.
+    ZoneSnapshot snapshot() const;
+    void invalidateSnapshot() { m_snapshotValid = false; }
 
 
 private:
+    friend class PageData;    // Maintains m_pageId as zones are added and removed
     friend class PageManager; // To allow PageManager to clear m_icons on page deletion more directly if needed
 
     QUuid m_id;
+    QUuid m_pageId;
     QString m_title;
     QRectF m_geometry;
     QColor m_backgroundColor;
@@ -52,6 +74,10 @@ private:
     QString m_backgroundImagePath;
     bool m_blurBackgroundImage;
     QList<IconData*> m_icons; // List of icons in this zone
+    QHash<QUuid, IconData*> m_iconIndex; // Same icons keyed by ID, for delta updates
+    QList<IconStackData*> m_stacks; // Owned; each holds its own icons
+    mutable ZoneSnapshot m_snapshot; // Shared with every published LayoutSnapshot until the zone changes
+    mutable bool m_snapshotValid = false;
 };
 
 #endif // ZONEDATA_H
@@ -5,7 +5,9 @@
 #include <QMouseEvent>
 #include <QGuiApplication> // For screen geometry or cursor control
 #include <QScreen>
+#include <QTimer>
 #include <QDebug>
+#include "Logging.h"
 #include <QApplication> // For qApp->setOverrideCursor
 #include <QMimeData>    // For drag and drop
 #include <QUrl>         // For file paths from drop
@@ -13,19 +15,35 @@
 #include <QColorDialog> // For color picking
 #include <QFileDialog>  // For selecting background image
 #include <QPainterPath> // For rounded rect clipping
-#include <QGraphicsBlurEffect> // For blurring image
-#include <QGraphicsScene>      // For using QGraphicsBlurEffect
-#include <QGraphicsPixmapItem> // For using QGraphicsBlurEffect
-#include <QGraphicsDropShadowEffect> // For drop shadows
+#include "ImageDecodeService.h" // For decoding (and blurring) the background image off the GUI thread
 #include "IconWidget.h" // For creating IconWidgets
+#include "IconPainter.h" // For painting icons directly in large zones
+#include "StaticTextCache.h" // For the title layout
+#include "DragGhost.h"  // For icon drags and zone moves
+#include "PerfMonitor.h" // For paint timings on the performance HUD
 #include "IconData.h"   // For creating IconData
+#include "IconStackWidget.h"
+#include "IconStackData.h"
 #include "PageTabContentWidget.h" // For qobject_cast to get parent PageData
 #include "ThemeManager.h" // For text color based on theme
+#include "PageData.h"     // For listing zones in "Send to Zone"
+#include <QRubberBand>  // For rubber-band selection
+#include <QKeyEvent>
+#include <QMessageBox>  // For bulk delete confirmation
+#include <QDesktopServices> // For launching painted icons
+#include <algorithm>    // For std::sort
+#include <cmath>        // For std::round
+
+bool ZoneWidget::s_paintIconsAlways = false;
+bool ZoneWidget::s_outlineResize = true;
 
 ZoneWidget::ZoneWidget(ZoneData* zoneData, PageManager* pageManager, QWidget *parent)
     : QWidget(parent), m_zoneData(zoneData), m_pageManager(pageManager),
       m_isResizing(false), m_isMoving(false), m_currentResizeRegion(ResizeRegion::None),
-      m_lastBlurState(false) // Initialize last blur state
+      m_lastBlurState(false), // Initialize last blur state
+      m_bgDecodePending(false),
+      m_rubberBand(nullptr), m_isSelecting(false),
+      m_paintedIcons(false), m_nextIconStackOrder(0), m_isDraggingIcon(false), m_dragGhost(nullptr)
 {
     Q_ASSERT(m_zoneData);
     Q_ASSERT(m_pageManager);
@@ -38,17 +56,31 @@ ZoneWidget::ZoneWidget(ZoneData* zoneData, PageManager* pageManager, QWidget *pa
     // Enable mouse tracking to get mouseMoveEvents even when no button is pressed (for cursor changes)
     setMouseTracking(true);
     setAcceptDrops(true); // Enable drag and drop onto this widget
+    setFocusPolicy(Qt::ClickFocus); // Keyboard actions on the icon selection
+
+    // Live resize: mouse moves only record the target; this applies it once per frame
+    m_resizeThrottle = new QTimer(this);
+    m_resizeThrottle->setSingleShot(true);
+    m_resizeThrottle->setTimerType(Qt::PreciseTimer);
+    connect(m_resizeThrottle, &QTimer::timeout, this, [this]() {
+        if (m_isResizing && m_pendingResizeGeometry != geometry()) {
+            setGeometry(m_pendingResizeGeometry);
+            m_resizeThrottle->start(); // Keep the cadence while the cursor is still moving
+        }
+    });
 
-    // Add drop shadow effect
-    QGraphicsDropShadowEffect* shadowEffect = new QGraphicsDropShadowEffect(this);
-    shadowEffect->setBlurRadius(15);
-    shadowEffect->setColor(QColor(0, 0, 0, 100)); // Semi-transparent black
-    shadowEffect->setOffset(4, 4);               // Offset to bottom-right
-    setGraphicsEffect(shadowEffect);
+    // No graphics effect for the drop shadow: it blurred the whole zone again on every repaint.
+    // The page paints the shadow instead; see paintShadow().
 
     // Custom context menu
     setContextMenuPolicy(Qt::CustomContextMenu);
     connect(this, &QWidget::customContextMenuRequested, this, [this](const QPoint &pos){
+        const QUuid iconId = paintedIconAt(pos);
+        if (!iconId.isNull()) {
+            showPaintedIconMenu(iconId, pos); // A painted icon has no widget of its own to ask
+            return;
+        }
+
         QMenu contextMenu(this);
         QAction *renameAction = contextMenu.addAction("Rename Zone...");
         connect(renameAction, &QAction::triggered, this, &ZoneWidget::renameZoneRequested);
@@ -74,6 +106,13 @@ ZoneWidget::ZoneWidget(ZoneData* zoneData, PageManager* pageManager, QWidget *pa
             connect(blurBgImageAction, &QAction::triggered, this, &ZoneWidget::toggleBlurBackgroundImageRequested);
         }
 
+        const int selectedCount = selectedIconIds().size();
+        if (selectedCount >= 2) {
+            contextMenu.addSeparator();
+            QAction *collapseAction = contextMenu.addAction(QString("Collapse %1 Selected Icons into Stack...").arg(selectedCount));
+            connect(collapseAction, &QAction::triggered, this, &ZoneWidget::collapseIconsIntoStackRequested);
+        }
+
         contextMenu.addSeparator();
         QAction *removeAction = contextMenu.addAction("Remove Zone");
         connect(removeAction, &QAction::triggered, this, &ZoneWidget::removeZoneRequested);
@@ -88,6 +127,9 @@ ZoneWidget::~ZoneWidget()
 {
     // IconWidgets are children of this, Qt handles their deletion.
     // ZoneData is owned by PageManager/PageData.
+    m_bgDecodeTicket.cancel(); // The callback is guarded anyway; this spares the worker the decode
+    delete m_dragGhost; // A child of the top-level window, not of this zone
+    delete m_resizeOutline; // Top-level, without a parent
     qDebug() << "ZoneWidget for" << (m_zoneData ? m_zoneData->title() : "Unknown") << "destroyed";
 }
 
@@ -100,53 +142,75 @@ void ZoneWidget::updateFromData()
 }
 
 
-void ZoneWidget::paintEvent(QPaintEvent *event)
+ShadowPainter::Shadow ZoneWidget::shadow()
 {
-    Q_UNUSED(event);
-    QPainter painter(this);
-    painter.setRenderHint(QPainter::Antialiasing);
+    return {15, QColor(0, 0, 0, 100), QPoint(4, 4)}; // Semi-transparent black, to the bottom-right
+}
 
+void ZoneWidget::paintShadow(QPainter* painter, const QRegion& exposed) const
+{
     if (!m_zoneData) return;
+    // The background layer fills the body with the zone's color first, so only its alpha matters
+    const bool opaque = m_zoneData->backgroundColor().alpha() == 255;
+    ShadowPainter::paint(painter, geometry(), m_zoneData->cornerRadius(), shadow(), exposed, opaque);
+}
 
-    // Prepare background image if path changed or not loaded
-    if (m_loadedBgImagePath != m_zoneData->backgroundImagePath() || m_cachedBgPixmap.isNull()) {
-        loadBackgroundImage(); // This will also prepare m_processedBgPixmap
-    } else if (!m_cachedBgPixmap.isNull() &&
-               (m_processedBgPixmap.isNull() || m_cachedBgPixmap.size() != m_processedBgPixmap.size() || m_zoneData->blurBackgroundImage() != m_lastBlurState)) {
-        // Re-process if blur state changed or pixmap sizes mismatch (e.g. after resize)
-        prepareProcessedBackgroundImage();
-    }
+void ZoneWidget::updateShadow(const QRect& previousGeometry)
+{
+    QWidget* page = parentWidget();
+    if (!page) return;
+    // Qt repaints the page under the zone's old rect itself, but not the shadow around it
+    page->update(previousGeometry.marginsAdded(shadowMargins()));
+    page->update(geometry().marginsAdded(shadowMargins()));
+}
 
+void ZoneWidget::moveEvent(QMoveEvent *event)
+{
+    QWidget::moveEvent(event);
+    updateShadow(QRect(event->oldPos(), size()));
+}
 
-    QPainterPath clipPath;
-    clipPath.addRoundedRect(rect(), m_zoneData->cornerRadius(), m_zoneData->cornerRadius());
+void ZoneWidget::resizeEvent(QResizeEvent *event)
+{
+    QWidget::resizeEvent(event);
+    updateShadow(QRect(pos(), event->oldSize()));
+}
 
-    painter.setClipPath(clipPath); // Clip drawing to the rounded rect
+void ZoneWidget::paintEvent(QPaintEvent *event)
+{
+    PerfMonitor::PaintScope paintTiming(PerfMonitor::PaintKind::Zone,
+                                        [this] { return m_zoneData ? m_zoneData->title() : QString(); });
+    QPainter painter(this);
+    painter.setRenderHint(QPainter::Antialiasing);
 
-    // Draw background color first
-    painter.fillPath(clipPath, m_zoneData->backgroundColor());
+    if (!m_zoneData) return;
 
-    // Draw background image if available and processed
-    if (!m_processedBgPixmap.isNull()) {
-        // Scale pixmap to fill the zone rect, maintaining aspect ratio and cropping if necessary.
-        // Qt::KeepAspectRatioByExpanding will make sure it covers, then clipping handles rounded corners.
-        QPixmap scaledPixmap = m_processedBgPixmap.scaled(size(), Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
-        QPointF pixmapOrigin = QPointF((width() - scaledPixmap.width()) / 2.0, (height() - scaledPixmap.height()) / 2.0);
-        painter.drawPixmap(pixmapOrigin, scaledPixmap);
+    // Request the background image when its path or blur state changed, or when the zone grew past
+    // the size it was decoded for. It is decoded on a worker; a failed path is not retried until it changes.
+    const QSize deviceSize = (QSizeF(size()) * devicePixelRatioF()).toSize();
+    if (m_loadedBgImagePath != m_zoneData->backgroundImagePath() || m_lastBlurState != m_zoneData->blurBackgroundImage()
+        || (!m_loadedBgImagePath.isEmpty() && ImageDecodeService::exceeds(deviceSize, m_bgRequestedSize))) {
+        loadBackgroundImage();
     }
 
-    // Border
-    painter.setPen(QPen(Qt::gray, 1)); // Border color from theme or data later
-    painter.drawPath(clipPath);
-
+    // Static layers come from the cache; only the exposed rects are copied. A drag step invalidates
+    // the tile's old and new position, and their bounding rect can span most of the zone.
+    const QRegion exposed = event->region();
+    ensureBackgroundLayer();
+    if (!m_backgroundLayer.isNull()) {
+        const qreal dpr = m_backgroundLayer.devicePixelRatio();
+        for (const QRect& rect : exposed) {
+            painter.drawPixmap(QRectF(rect), m_backgroundLayer,
+                               QRectF(QPointF(rect.topLeft()) * dpr, QSizeF(rect.size()) * dpr));
+        }
+    }
 
-    // Title - Ensure text is drawn *after* clipping and background fill
-    painter.setClipping(false); // Disable clipping for text
+    // Title - drawn on top of the cached layer whenever its bar is exposed
 
     // Determine text color based on effective background (image or color)
     // This is a simple heuristic. A more robust way might involve analyzing average color under text.
     QColor effectiveBgColor = m_zoneData->backgroundColor();
-    if (!m_processedBgPixmap.isNull()) {
+    if (!m_backgroundImage.isNull()) {
         // If there's an image, assume it might be varied. A fixed contrasting color might be better.
         // For now, let's try a fixed color or one that contrasts with a semi-transparent overlay.
         // Or, allow user to set title text color.
@@ -159,21 +223,52 @@ void ZoneWidget::paintEvent(QPaintEvent *event)
     // This is complex. Let's use theme-provided text color as a base, or a fixed one.
     // The current theme sets ZoneWidget { color: ... }, let's try to use that if this is too complex.
     // For now, stick to simple contrast with the zone's main BG color or a default if image.
-    if (!m_processedBgPixmap.isNull()) {
+    if (!m_backgroundImage.isNull()) {
         textColor = (ThemeManager::currentTheme() == ThemeManager::Theme::Dark) ? Qt::white : Qt::black;
     } else {
          textColor = (m_zoneData->backgroundColor().lightnessF() < 0.5) ? Qt::white : Qt::black;
     }
     painter.setPen(textColor);
 
-    QFont font = painter.font();
-    font.setPointSize(10);
-    painter.setFont(font);
+    // Simple title bar area (top part of the zone), max 20px high
+    QRectF titleBarRect(0, 0, width(), qMin(20, height()));
+    if (exposed.intersects(titleBarRect.toAlignedRect())) {
+        if (!(painter.font() == m_titleBaseFont)) { // Only after a theme or font change
+            m_titleBaseFont = painter.font();
+            m_titleFont = m_titleBaseFont;
+            m_titleFont.setPointSize(10);
+        }
+        painter.setFont(m_titleFont);
 
-    QRectF textRect = rect().adjusted(5, 2, -5, -2); // Margins for text
-    // Simple title bar area (top part of the zone)
-    QRectF titleBarRect(0, 0, width(), qMin(20, height())); // Max 20px high title bar
-    painter.drawText(titleBarRect.adjusted(5,0,-5,0), Qt::AlignLeft | Qt::AlignVCenter, m_zoneData->title());
+        // The title is shaped once per text and width; a rename or resize asks the cache for a new layout
+        const QStaticText title = StaticTextCache::text(m_zoneData->title(), m_titleFont, width() - 10, 1, Qt::ElideRight);
+        painter.drawStaticText(QPointF(5, (titleBarRect.height() - title.size().height()) / 2.0), title);
+    }
+
+    if (m_paintedIcons) {
+        // Only icons intersecting the exposed rects: a drag step repaints two tiles, not the whole zone.
+        // A tile crossing two rects is collected once; the painter's clip keeps it inside the region.
+        QList<QUuid> exposedIds;
+        QSet<QUuid> seenIds;
+        for (const QRect& rect : exposed) {
+            const QList<QUuid> ids = m_iconIndex.query(rect);
+            for (const QUuid& id : ids) {
+                if (!seenIds.contains(id)) {
+                    seenIds.insert(id);
+                    exposedIds.append(id);
+                }
+            }
+        }
+        std::sort(exposedIds.begin(), exposedIds.end(), [this](const QUuid& a, const QUuid& b) {
+            return m_iconStackOrder.value(a) < m_iconStackOrder.value(b);
+        });
+        for (const QUuid& id : std::as_const(exposedIds)) {
+            IconData* icon = m_zoneData->findIcon(id);
+            if (!icon || m_hiddenIconIds.contains(id)) continue;
+            IconPainter::paint(&painter, m_iconIndex.rectOf(id), icon, paintedIconImage(icon),
+                               m_selectedIconIds.contains(id), id == m_hoveredIconId);
+        }
+    }
 
     // If resizing, could draw resize handles
     // if (m_isResizing || underMouse()) { // Or always if underMouse()
@@ -187,6 +282,24 @@ void ZoneWidget::mousePressEvent(QMouseEvent *event)
 {
     if (!m_zoneData) return;
 
+    // Painted icons take the click before the zone, as an IconWidget child would
+    const QUuid pressedIconId = event->button() == Qt::LeftButton ? paintedIconAt(event->position().toPoint()) : QUuid();
+    if (!pressedIconId.isNull()) {
+        if (event->modifiers() & Qt::ControlModifier) {
+            setIconSelected(pressedIconId, !m_selectedIconIds.contains(pressedIconId)); // Toggle, no drag
+            event->accept();
+            return;
+        }
+        if (!m_selectedIconIds.contains(pressedIconId)) {
+            clearSelection(); // Plain click on an unselected icon drags just this icon
+        }
+        beginIconDrag(pressedIconId, event->position().toPoint());
+        m_iconStackOrder.insert(pressedIconId, ++m_nextIconStackOrder); // Bring to front, where it lands on drop
+        update(m_iconIndex.rectOf(pressedIconId));
+        event->accept();
+        return;
+    }
+
     if (event->button() == Qt::LeftButton) {
         m_mousePressPosition = event->globalPosition().toPoint();
         m_dragStartPosition = event->position().toPoint();
@@ -196,18 +309,30 @@ void ZoneWidget::mousePressEvent(QMouseEvent *event)
 
         if (m_currentResizeRegion != ResizeRegion::None && m_currentResizeRegion != ResizeRegion::Move) {
             m_isResizing = true;
-            qDebug() << "Starting resize op:" << m_currentResizeRegion;
+            const qreal refreshRate = screen() && screen()->refreshRate() > 0 ? screen()->refreshRate() : 60.0;
+            m_resizeThrottle->setInterval(qMax(1, qRound(1000.0 / refreshRate)));
+            qCDebug(lcZone) << "Starting resize op:" << m_currentResizeRegion;
         } else {
             // Check if click is on title bar area for moving
             QRectF titleBarRect(0, 0, width(), qMin(20, height()));
             if (titleBarRect.contains(event->position())) {
                  m_isMoving = true;
                  m_currentResizeRegion = ResizeRegion::Move; // Ensure region is set for move
-                 qDebug() << "Starting move op";
+                 qCDebug(lcZone) << "Starting move op";
             } else {
-                // If not on title bar and not a resize region, treat as non-moving click for now
-                // Could be used for selection later
+                // Empty area: start a rubber-band selection. Ctrl extends the current selection.
                 m_currentResizeRegion = ResizeRegion::None;
+                if (!(event->modifiers() & Qt::ControlModifier)) {
+                    clearSelection();
+                }
+                m_selectionBeforeBand = m_selectedIconIds;
+                m_selectionOrigin = event->position().toPoint();
+                m_isSelecting = true;
+                if (!m_rubberBand) {
+                    m_rubberBand = new QRubberBand(QRubberBand::Rectangle, this);
+                }
+                m_rubberBand->setGeometry(QRect(m_selectionOrigin, QSize()));
+                m_rubberBand->show();
             }
         }
         event->accept();
@@ -218,34 +343,85 @@ void ZoneWidget::mousePressEvent(QMouseEvent *event)
 
 void ZoneWidget::filterIcons(const QString& filterText)
 {
-    qDebug() << "ZoneWidget" << (m_zoneData ? m_zoneData->title() : "N/A") << "filtering icons with text:" << filterText;
+    qCDebug(lcFilter) << "ZoneWidget" << (m_zoneData ? m_zoneData->title() : "N/A") << "filtering icons with text:" << filterText;
     bool searchIsEmpty = filterText.isEmpty();
+    // Lowercase once per call; each icon's search key is already lowercase, so matching is a
+    // plain contains() with no per-icon QFileInfo or string allocation.
+    // The key is the full path, and the display name is a suffix of it, so one check covers both.
+    const QString needle = filterText.toLower();
+    m_filterNeedle = needle;
+    if (m_paintedIcons && m_zoneData) {
+        // No widgets to hide: painting and hit testing skip the icons in this set
+        m_hiddenIconIds.clear();
+        if (!searchIsEmpty) {
+            for (IconData* icon : m_zoneData->icons()) {
+                if (!icon->searchKey().contains(needle)) m_hiddenIconIds.insert(icon->id());
+            }
+        }
+        if (m_hiddenIconIds.contains(m_hoveredIconId)) setHoveredIcon(QUuid());
+        update();
+    }
     for (IconWidget* iconWidget : m_iconWidgets) {
         if (iconWidget && iconWidget->data()) {
             if (searchIsEmpty) {
                 iconWidget->setVisible(true);
             } else {
-                bool nameMatch = iconWidget->data()->displayName().contains(filterText, Qt::CaseInsensitive);
-                bool pathMatch = iconWidget->data()->filePath().contains(filterText, Qt::CaseInsensitive);
-                iconWidget->setVisible(nameMatch || pathMatch);
+                iconWidget->setVisible(iconWidget->data()->searchKey().contains(needle));
             }
         }
     }
+    // A stack stays visible if any member matches
+    for (IconStackWidget* stackWidget : std::as_const(m_stackWidgetById)) {
+        if (stackWidget->data()) {
+            stackWidget->setVisible(searchIsEmpty || stackWidget->data()->matches(needle));
+        }
+    }
 }
 
 void ZoneWidget::mouseMoveEvent(QMouseEvent *event)
 {
     if (!m_zoneData) return;
 
-    if (m_isResizing) {
+    if (m_isDraggingIcon) {
+        if (event->buttons() & Qt::LeftButton) {
+            updateIconDrag(event->globalPosition().toPoint()); // Moves the ghost; the painted icons stay put
+        }
+        event->accept();
+    } else if (m_isResizing) {
         handleResize(event->globalPosition().toPoint());
         event->accept();
     } else if (m_isMoving) {
         handleMove(event->globalPosition().toPoint());
         event->accept();
+    } else if (m_isSelecting) {
+        QRect band = QRect(m_selectionOrigin, event->position().toPoint()).normalized();
+        m_rubberBand->setGeometry(band);
+        // The index returns only icons in the cells the band covers
+        QSet<QUuid> newSelection = m_selectionBeforeBand;
+        const QList<QUuid> hits = m_iconIndex.query(band);
+        for (const QUuid& id : hits) {
+            if (isIconShown(id)) { // Icons hidden by the filter are not selectable
+                newSelection.insert(id);
+            }
+        }
+        for (const QUuid& id : std::as_const(m_selectedIconIds)) {
+            if (!newSelection.contains(id)) showIconSelection(id, false);
+        }
+        for (const QUuid& id : std::as_const(newSelection)) {
+            if (!m_selectedIconIds.contains(id)) showIconSelection(id, true);
+        }
+        m_selectedIconIds = newSelection;
+        event->accept();
     } else {
+        if (m_paintedIcons) {
+            setHoveredIcon(paintedIconAt(event->position().toPoint()));
+        }
         // Update cursor even if not dragging/resizing
-        updateCursorShape(event->position().toPoint());
+        if (!m_hoveredIconId.isNull()) {
+            setCursor(Qt::PointingHandCursor);
+        } else {
+            updateCursorShape(event->position().toPoint());
+        }
         QWidget::mouseMoveEvent(event);
     }
 }
@@ -255,19 +431,37 @@ void ZoneWidget::mouseReleaseEvent(QMouseEvent *event)
     if (!m_zoneData) return;
 
     if (event->button() == Qt::LeftButton) {
+        if (m_isDraggingIcon) {
+            finishIconDrag(event->globalPosition().toPoint());
+        }
         if (m_isResizing || m_isMoving) {
+            if (m_isResizing) {
+                m_resizeThrottle->stop();
+                if (m_resizeOutline) m_resizeOutline->hide();
+                setGeometry(resizedGeometry(event->globalPosition().toPoint())); // Outline mode: the only resize of the gesture
+            }
+            if (m_isMoving && m_dragGhost) {
+                delete m_dragGhost;
+                m_dragGhost = nullptr;
+                move(movedTopLeft(event->globalPosition().toPoint())); // The only move of the whole gesture
+            }
             m_isResizing = false;
             m_isMoving = false;
 
             // Update ZoneData with the new geometry
             m_zoneData->setGeometry(QRectF(geometry()));
             // Notify PageManager that data has changed (so it can be saved, etc.)
-            m_pageManager->updateZoneData(m_zoneData);
+            m_pageManager->notifyZoneGeometryChanged(m_zoneData);
 
-            qDebug() << "Finished move/resize. New geometry:" << geometry();
+            qCDebug(lcZone) << "Finished move/resize. New geometry:" << geometry();
             unsetCursor(); // Reset cursor to normal arrow
             m_currentResizeRegion = ResizeRegion::None;
         }
+        if (m_isSelecting) {
+            m_isSelecting = false;
+            m_selectionBeforeBand.clear();
+            if (m_rubberBand) m_rubberBand->hide();
+        }
         event->accept();
     } else {
         QWidget::mouseReleaseEvent(event);
@@ -286,7 +480,7 @@ void ZoneWidget::leaveEvent(QEvent *event)
     if (!m_isResizing && !m_isMoving) { // Don't unset cursor if an operation is in progress
         unsetCursor();
     }
-    // update();
+    setHoveredIcon(QUuid());
 }
 
 ZoneWidget::ResizeRegion ZoneWidget::getResizeRegion(const QPoint& pos)
@@ -363,7 +557,21 @@ void ZoneWidget::updateCursorShape(const QPoint& pos)
 void ZoneWidget::handleMove(const QPoint& newMouseGlobalPos)
 {
     if (!m_isMoving) return;
-    QPoint delta = newMouseGlobalPos - m_mousePressPosition;
+    if (!m_dragGhost) {
+        if ((newMouseGlobalPos - m_mousePressPosition).manhattanLength() < QApplication::startDragDistance()) {
+            return; // Still a click on the title bar
+        }
+        // The zone stays where it is: moving it would repaint the page and every zone it overlaps at input rate
+        m_dragGhost = new DragGhost(grab(), this);
+    }
+    const QPoint newTopLeft = movedTopLeft(newMouseGlobalPos);
+    m_dragGhost->moveTo(parentWidget() ? parentWidget()->mapToGlobal(newTopLeft) : newTopLeft);
+    // The zone is moved and ZoneData updated on mouseRelease
+}
+
+QPoint ZoneWidget::movedTopLeft(const QPoint& globalPos) const
+{
+    QPoint delta = globalPos - m_mousePressPosition;
     // New top-left position for the widget, relative to its parent.
     // m_originalGeometry is the geometry of the widget itself at the start of the move.
     // m_dragStartPosition is the click position *within* the widget.
@@ -377,14 +585,35 @@ void ZoneWidget::handleMove(const QPoint& newMouseGlobalPos)
     //     newTopLeft.setY(qBound(0, newTopLeft.y(), parentWidget()->height() - height()));
     // }
 
-    move(newTopLeft);
-    // Geometry in ZoneData will be updated on mouseRelease
+    return newTopLeft;
 }
 
 void ZoneWidget::handleResize(const QPoint& newMouseGlobalPos)
 {
     if (!m_isResizing) return;
+    const QRect newGeometry = resizedGeometry(newMouseGlobalPos);
+
+    if (s_outlineResize) {
+        // Only the frame follows the cursor: no resize event, background rescale or repaint until release
+        if (!m_resizeOutline) {
+            m_resizeOutline = new QRubberBand(QRubberBand::Rectangle); // No parent: its own window
+        }
+        const QPoint globalTopLeft = parentWidget() ? parentWidget()->mapToGlobal(newGeometry.topLeft()) : newGeometry.topLeft();
+        m_resizeOutline->setGeometry(QRect(globalTopLeft, newGeometry.size()));
+        m_resizeOutline->show();
+        return;
+    }
 
+    // Live: the first step applies at once, later ones at most once per frame; ZoneData is updated on mouseRelease
+    m_pendingResizeGeometry = newGeometry;
+    if (!m_resizeThrottle->isActive()) {
+        setGeometry(newGeometry);
+        m_resizeThrottle->start();
+    }
+}
+
+QRect ZoneWidget::resizedGeometry(const QPoint& newMouseGlobalPos) const
+{
     QRect newGeometry = m_originalGeometry.toRect();
     QPoint delta = newMouseGlobalPos - m_mousePressPosition; // How much mouse moved globally
 
@@ -418,7 +647,7 @@ void ZoneWidget::handleResize(const QPoint& newMouseGlobalPos)
             newGeometry.setBottomRight(m_originalGeometry.bottomRight().toPoint() + delta);
             break;
         default:
-            return; // Should not happen if m_isResizing is true
+            return newGeometry; // Should not happen if m_isResizing is true
     }
 
     // Enforce minimum size
@@ -437,10 +666,8 @@ void ZoneWidget::handleResize(const QPoint& newMouseGlobalPos)
         }
     }
 
-    // Update widget's geometry
     // The geometry is relative to the parent, which is PageTabContentWidget
-    setGeometry(newGeometry);
-    // Actual ZoneData geometry is updated on mouseRelease
+    return newGeometry;
 }
 
 void ZoneWidget::contextMenuEvent(QContextMenuEvent *event)
@@ -455,6 +682,13 @@ void ZoneWidget::mouseDoubleClickEvent(QMouseEvent *event)
 {
     if (!m_zoneData) return;
 
+    const QUuid iconId = event->button() == Qt::LeftButton ? paintedIconAt(event->position().toPoint()) : QUuid();
+    if (!iconId.isNull()) {
+        launchIcon(iconId);
+        event->accept();
+        return;
+    }
+
     QRectF titleBarRect(0, 0, width(), qMin(20, height()));
     if (titleBarRect.contains(event->position())) {
         if (event->button() == Qt::LeftButton) {
@@ -500,7 +734,7 @@ void ZoneWidget::renameZoneRequested() {
 
     if (ok && !newTitle.isEmpty() && newTitle != currentTitle) {
         m_zoneData->setTitle(newTitle);
-        m_pageManager->updateZoneData(m_zoneData); // Notifies for save and repaint
+        m_pageManager->notifyZoneTitleChanged(m_zoneData); // Notifies for save and repaint
         update(); // Immediate repaint of this widget
         qDebug() << "Zone ID" << m_zoneData->id() << "renamed to" << newTitle;
     }
@@ -515,7 +749,7 @@ void ZoneWidget::changeBackgroundColorRequested() {
 
     if (newColor.isValid()) {
         m_zoneData->setBackgroundColor(newColor);
-        m_pageManager->updateZoneData(m_zoneData); // Notifies for save and repaint
+        m_pageManager->notifyZoneStyleChanged(m_zoneData); // Notifies for save and repaint
         update(); // Immediate repaint of this widget
         qDebug() << "Zone ID" << m_zoneData->id() << "background color changed to" << newColor.name(QColor::HexArgb);
     }
@@ -530,7 +764,7 @@ void ZoneWidget::setCornerRadiusRequested() {
 
     if (ok && newRadius != currentRadius) {
         m_zoneData->setCornerRadius(newRadius);
-        m_pageManager->updateZoneData(m_zoneData);
+        m_pageManager->notifyZoneStyleChanged(m_zoneData);
         update(); // Repaint for new radius
         qDebug() << "Zone ID" << m_zoneData->id() << "corner radius set to" << newRadius;
     }
@@ -545,7 +779,7 @@ void ZoneWidget::setBackgroundImageRequested() {
     if (!filePath.isEmpty()) {
         m_zoneData->setBackgroundImagePath(filePath);
         m_loadedBgImagePath.clear(); // Force reload
-        m_pageManager->updateZoneData(m_zoneData);
+        m_pageManager->notifyZoneStyleChanged(m_zoneData);
         update();
         qDebug() << "Zone ID" << m_zoneData->id() << "background image set to" << filePath;
     }
@@ -557,10 +791,7 @@ void ZoneWidget::clearBackgroundImageRequested() {
     if (!m_zoneData->backgroundImagePath().isEmpty()) {
         m_zoneData->setBackgroundImagePath(QString()); // Clear path
         m_zoneData->setBlurBackgroundImage(false); // Also reset blur if image is cleared
-        m_cachedBgPixmap = QPixmap(); // Clear cache
-        m_processedBgPixmap = QPixmap();
-        m_loadedBgImagePath.clear();
-        m_pageManager->updateZoneData(m_zoneData);
+        m_pageManager->notifyZoneStyleChanged(m_zoneData);
         update();
         qDebug() << "Zone ID" << m_zoneData->id() << "background image cleared.";
     }
@@ -570,78 +801,123 @@ void ZoneWidget::toggleBlurBackgroundImageRequested() {
     if (!m_zoneData || !m_pageManager || m_zoneData->backgroundImagePath().isEmpty()) return;
 
     m_zoneData->setBlurBackgroundImage(!m_zoneData->blurBackgroundImage());
-    // No need to clear m_cachedBgPixmap, just re-process it
-    m_processedBgPixmap = QPixmap(); // Force re-processing
-    m_pageManager->updateZoneData(m_zoneData);
+    // paintEvent requests the other version; the current one stays up until it arrives
+    m_pageManager->notifyZoneStyleChanged(m_zoneData);
     update();
     qDebug() << "Zone ID" << m_zoneData->id() << "blur background image toggled to" << m_zoneData->blurBackgroundImage();
 }
 
+void ZoneWidget::collapseIconsIntoStackRequested() {
+    if (!m_zoneData || !m_pageManager) return;
+    const QList<QUuid> iconIds = selectedIconIds(); // Only the selection; the rest stay loose
+    if (iconIds.size() < 2) return;
+
+    bool ok;
+    QString title = QInputDialog::getText(this, "Collapse Icons into Stack", "Enter stack title:", QLineEdit::Normal, m_zoneData->title(), &ok);
+    if (!ok || title.isEmpty()) return;
+
+    clearSelection(); // The members leave the loose icons
+    PageManager::BatchScope batch(m_pageManager);
+    if (m_zoneData->collapseIcons(iconIds, title)) {
+        m_pageManager->notifyIconsRemoved(m_zoneData, iconIds); // Drops their widgets
+        m_pageManager->notifyZoneStacksChanged(m_zoneData);     // Adds the single tile and rewrites the members' rows
+    }
+}
+
 
 // --- Image Loading and Processing ---
 void ZoneWidget::loadBackgroundImage() {
-    if (!m_zoneData || m_zoneData->backgroundImagePath().isEmpty()) {
-        m_cachedBgPixmap = QPixmap();
-        m_processedBgPixmap = QPixmap();
-        m_loadedBgImagePath.clear();
-        return;
-    }
+    if (!m_zoneData) return;
+    m_bgDecodeTicket.cancel(); // A result for the previous path or blur state is no longer wanted
 
-    if (m_loadedBgImagePath == m_zoneData->backgroundImagePath() && !m_cachedBgPixmap.isNull()) {
-        // Already loaded and path hasn't changed
-        prepareProcessedBackgroundImage(); // Ensure processed one is up-to-date (e.g. blur state)
+    const QString path = m_zoneData->backgroundImagePath();
+    const bool pathChanged = (m_loadedBgImagePath != path);
+    m_loadedBgImagePath = path;
+    m_lastBlurState = m_zoneData->blurBackgroundImage();
+    if (path.isEmpty()) {
+        m_backgroundImage = QImage();
+        m_bgRequestedSize = QSize();
+        m_bgDecodePending = false;
+        update();
         return;
     }
-
-    QPixmap pixmap(m_zoneData->backgroundImagePath());
-    if (pixmap.isNull()) {
-        qWarning() << "Failed to load background image:" << m_zoneData->backgroundImagePath();
-        m_cachedBgPixmap = QPixmap();
-        m_processedBgPixmap = QPixmap();
-        m_loadedBgImagePath.clear();
-    } else {
-        m_cachedBgPixmap = pixmap;
-        m_loadedBgImagePath = m_zoneData->backgroundImagePath();
-        qDebug() << "Loaded background image" << m_loadedBgImagePath << "for zone" << m_zoneData->id() << "Size:" << m_cachedBgPixmap.size();
+    if (pathChanged) {
+        m_backgroundImage = QImage(); // Placeholder until the new image arrives; a blur toggle or growth keeps the old one up
     }
-    prepareProcessedBackgroundImage(); // Prepare initial processed version
+
+    ImageDecodeRequest request;
+    request.path = path;
+    // Decoded only as large as the zone shows it, rounded up so small resizes reuse it
+    request.targetSize = ImageDecodeService::bucketedSize((QSizeF(size()) * devicePixelRatioF()).toSize());
+    request.blurRadius = m_lastBlurState ? BLUR_RADIUS : 0; // Blurred on the worker too, at the decoded size
+    m_bgRequestedSize = request.targetSize;
+    m_bgDecodePending = true;
+    m_bgDecodeTicket = ImageDecodeService::instance()->decode(request, this, [this](const QImage& image) {
+        handleBackgroundImageDecoded(image);
+    });
+    update();
 }
 
-void ZoneWidget::prepareProcessedBackgroundImage() {
-    if (m_cachedBgPixmap.isNull()) {
-        m_processedBgPixmap = QPixmap();
-        m_lastBlurState = m_zoneData ? m_zoneData->blurBackgroundImage() : false;
-        return;
+void ZoneWidget::handleBackgroundImageDecoded(const QImage& image) {
+    m_bgDecodePending = false;
+    if (image.isNull()) {
+        qWarning() << "Failed to load background image:" << m_loadedBgImagePath;
+        m_backgroundImage = QImage();
+    } else {
+        m_backgroundImage = image; // Shares the cached pixels
+        qCDebug(lcZone) << "Background image ready for zone" << (m_zoneData ? m_zoneData->id() : QUuid())
+                        << "Size:" << image.size() << "Blurred:" << m_lastBlurState;
     }
+    update();
+    notifyContentReady(rect()); // Replaces the decoding placeholder everywhere
+}
 
-    if (m_zoneData->blurBackgroundImage()) {
-        // Simple blur: Scale down, then scale up with smooth transform
-        // This is a very basic and often not great looking blur.
-        // For a better blur, QGraphicsBlurEffect is preferred but requires a scene or more setup.
-        // Let's try a QGraphicsBlurEffect approach by rendering to an image.
+void ZoneWidget::ensureBackgroundLayer()
+{
+    if (!m_zoneData || width() <= 0 || height() <= 0) return;
+
+    BackgroundLayerKey key;
+    key.size = size();
+    key.devicePixelRatio = devicePixelRatioF();
+    key.cornerRadius = m_zoneData->cornerRadius();
+    key.color = m_zoneData->backgroundColor().rgba();
+    key.imageCacheKey = m_backgroundImage.isNull() ? 0 : m_backgroundImage.cacheKey();
+    key.blur = m_lastBlurState;
+    key.placeholder = m_bgDecodePending && m_backgroundImage.isNull();
+    if (key == m_backgroundLayerKey && !m_backgroundLayer.isNull()) return;
+    m_backgroundLayerKey = key;
+
+    const QSize deviceSize = (QSizeF(size()) * key.devicePixelRatio).toSize();
+    QPixmap layer(deviceSize);
+    layer.setDevicePixelRatio(key.devicePixelRatio); // Painted in logical coordinates, stored at device resolution
+    layer.fill(Qt::transparent);
+
+    QPainter painter(&layer);
+    painter.setRenderHint(QPainter::Antialiasing);
+    painter.setRenderHint(QPainter::SmoothPixmapTransform);
 
-        QImage sourceImage = m_cachedBgPixmap.toImage().convertToFormat(QImage::Format_ARGB32_Premultiplied);
-        QGraphicsScene scene;
-        QGraphicsPixmapItem item(QPixmap::fromImage(sourceImage));
-        QGraphicsBlurEffect *blur = new QGraphicsBlurEffect;
-        blur->setBlurRadius(8); // Adjust blur radius as needed
-        item.setGraphicsEffect(blur);
-        scene.addItem(&item);
+    QPainterPath clipPath;
+    clipPath.addRoundedRect(rect(), key.cornerRadius, key.cornerRadius);
+    painter.setClipPath(clipPath); // Clip drawing to the rounded rect
+    painter.fillPath(clipPath, m_zoneData->backgroundColor());
 
-        QImage resultImage(sourceImage.size(), QImage::Format_ARGB32_Premultiplied);
-        resultImage.fill(Qt::transparent);
-        QPainter p(&resultImage);
-        scene.render(&p, QRectF(), QRectF(0,0,sourceImage.width(), sourceImage.height()));
-        p.end();
+    if (key.placeholder) {
+        painter.fillPath(clipPath, QBrush(QColor(128, 128, 128, 60), Qt::BDiagPattern)); // Image still decoding
+    }
+    if (!m_backgroundImage.isNull()) {
+        // Cover the zone keeping the aspect ratio; scaled straight to device pixels so HiDPI stays sharp
+        QImage scaledImage = m_backgroundImage.scaled(deviceSize, Qt::KeepAspectRatioByExpanding, Qt::SmoothTransformation);
+        scaledImage.setDevicePixelRatio(key.devicePixelRatio);
+        const QSizeF logicalSize = QSizeF(scaledImage.size()) / key.devicePixelRatio;
+        painter.drawImage(QPointF((width() - logicalSize.width()) / 2.0, (height() - logicalSize.height()) / 2.0), scaledImage);
+    }
 
-        m_processedBgPixmap = QPixmap::fromImage(resultImage);
-        qDebug() << "Applied blur to background image for zone" << m_zoneData->id();
+    painter.setPen(QPen(Qt::gray, 1)); // Border color from theme or data later
+    painter.drawPath(clipPath);
+    painter.end();
 
-    } else {
-        m_processedBgPixmap = m_cachedBgPixmap; // No blur, use original cached
-    }
-    m_lastBlurState = m_zoneData->blurBackgroundImage();
-    update(); // Request repaint as processed image changed
+    m_backgroundLayer = layer;
+    qCDebug(lcZone) << "Rebuilt background layer for zone" << m_zoneData->id() << "at" << deviceSize;
 }
 
 
@@ -649,20 +925,34 @@ void ZoneWidget::prepareProcessedBackgroundImage() {
 
 void ZoneWidget::loadOrUpdateIcons() {
     if (!m_zoneData) return;
+    switchIconRenderModeIfNeeded();
 
-    // Sync m_iconWidgets with m_zoneData->icons()
-    QList<QUuid> currentIconDataIds;
-    for (IconData* id : m_zoneData->icons()) {
-        currentIconDataIds.append(id->id());
+    if (m_paintedIcons) {
+        // Same reconcile against the index: drop icons that left, re-read the rest from their data
+        const QList<QUuid> indexedIds = m_iconStackOrder.keys();
+        for (const QUuid& id : indexedIds) {
+            if (!m_zoneData->findIcon(id)) removePaintedIcon(id);
+        }
+        for (IconData* iconD : m_zoneData->icons()) {
+            indexPaintedIcon(iconD);
+        }
+        loadOrUpdateStacks();
+        update();
+        return;
     }
 
-    // Remove IconWidgets for icons that no longer exist in data
-    for (int i = m_iconWidgets.size() - 1; i >= 0; --i) {
-        IconWidget* iw = m_iconWidgets.at(i);
-        if (!iw->data() || !currentIconDataIds.contains(iw->data()->id())) {
-            m_iconWidgets.removeAt(i);
-            iw->deleteLater();
-            qDebug() << "Removed IconWidget for stale/missing IconData ID:" << (iw->data() ? iw->data()->id().toString() : "Unknown");
+    // Remove IconWidgets for icons that no longer exist in data.
+    // Look up by the widget's key rather than iw->data(): the IconData may already be deleted.
+    for (auto it = m_iconWidgetById.begin(); it != m_iconWidgetById.end();) {
+        if (!m_zoneData->findIcon(it.key())) {
+            IconWidget* iw = it.value();
+            qCDebug(lcIcon) << "Removed IconWidget for stale/missing IconData ID:" << it.key();
+            m_iconIndex.remove(it.key());
+            m_selectedIconIds.remove(it.key());
+            it = m_iconWidgetById.erase(it);
+            destroyIconWidget(iw);
+        } else {
+            ++it;
         }
     }
 
@@ -671,23 +961,651 @@ void ZoneWidget::loadOrUpdateIcons() {
         IconWidget* existingWidget = findIconWidget(iconD->id());
         if (existingWidget) {
             existingWidget->updateFromData(); // Update position or other visuals
+            m_iconIndex.insert(iconD->id(), existingWidget->geometry());
         } else {
-            IconWidget* newIconWidget = new IconWidget(iconD, m_pageManager, this);
-            m_iconWidgets.append(newIconWidget);
-            newIconWidget->show();
-            qDebug() << "Created IconWidget for IconData ID:" << iconD->id() << "Path:" << iconD->filePath();
+            createIconWidget(iconD);
         }
     }
+    loadOrUpdateStacks();
     update(); // Repaint zone if icon changes might affect it (e.g. bounds checks)
 }
 
+void ZoneWidget::loadOrUpdateStacks() {
+    if (!m_zoneData) return;
+
+    for (auto it = m_stackWidgetById.begin(); it != m_stackWidgetById.end();) {
+        if (!m_zoneData->findStack(it.key())) {
+            IconStackWidget* stackWidget = it.value();
+            it = m_stackWidgetById.erase(it);
+            stackWidget->detachData(); // Its IconStackData is already deleted
+            stackWidget->hide();
+            stackWidget->deleteLater();
+        } else {
+            ++it;
+        }
+    }
+
+    for (IconStackData* stack : m_zoneData->stacks()) {
+        IconStackWidget* stackWidget = m_stackWidgetById.value(stack->id(), nullptr);
+        if (stackWidget) {
+            stackWidget->updateFromData();
+        } else {
+            stackWidget = new IconStackWidget(stack, m_pageManager, this);
+            m_stackWidgetById.insert(stack->id(), stackWidget);
+            stackWidget->setVisible(m_filterNeedle.isEmpty() || stack->matches(m_filterNeedle));
+        }
+    }
+}
+
+IconWidget* ZoneWidget::createIconWidget(IconData* iconData) {
+    IconWidget* newIconWidget = new IconWidget(iconData, m_pageManager, this);
+    m_iconWidgets.append(newIconWidget);
+    m_iconWidgetById.insert(iconData->id(), newIconWidget);
+    m_iconIndex.insert(iconData->id(), newIconWidget->geometry());
+    newIconWidget->setSelected(m_selectedIconIds.contains(iconData->id())); // Kept across a switch from painted mode
+    newIconWidget->setVisible(m_filterNeedle.isEmpty() || iconData->searchKey().contains(m_filterNeedle));
+    qCDebug(lcIcon) << "Created IconWidget for IconData ID:" << iconData->id() << "Path:" << iconData->filePath();
+    return newIconWidget;
+}
+
+void ZoneWidget::destroyIconWidget(IconWidget* iconWidget) {
+    if (!iconWidget) return;
+    if (iconWidget->data() && m_draggedIconIds.contains(iconWidget->data()->id())) cancelIconDrag();
+    m_iconWidgets.removeOne(iconWidget);
+    iconWidget->detachData(); // Its IconData is usually gone already or owned by another zone
+    iconWidget->hide(); // Make sure it is never painted again
+    iconWidget->deleteLater();
+}
+
+IconWidget* ZoneWidget::releaseIconWidget(const QUuid& iconId) {
+    if (m_paintedIcons) {
+        removePaintedIcon(iconId);
+        return nullptr; // Nothing to hand over; the target builds its own
+    }
+    IconWidget* iconWidget = m_iconWidgetById.take(iconId);
+    if (!iconWidget) return nullptr;
+    if (m_draggedIconIds.contains(iconId)) cancelIconDrag();
+    m_iconWidgets.removeOne(iconWidget);
+    m_iconIndex.remove(iconId);
+    m_selectedIconIds.remove(iconId);
+    iconWidget->setSelected(false);
+    return iconWidget;
+}
+
+void ZoneWidget::adoptIconWidget(IconData* iconData, IconWidget* iconWidget) {
+    if (!iconData) return;
+    if (wantsPaintedIcons() != m_paintedIcons) {
+        destroyIconWidget(iconWidget);
+        loadOrUpdateIcons(); // Crossed the threshold: rebuild in the other mode, the adopted icon included
+        return;
+    }
+    if (m_paintedIcons) {
+        destroyIconWidget(iconWidget); // Came from a zone with widgets; this one paints
+        indexPaintedIcon(iconData);
+        return;
+    }
+    if (!iconWidget) {
+        createIconWidget(iconData);
+        return;
+    }
+    iconWidget->setParentZoneWidget(this, iconData); // Reparents; the widget is not recreated
+    m_iconWidgets.append(iconWidget);
+    m_iconWidgetById.insert(iconData->id(), iconWidget);
+    m_iconIndex.insert(iconData->id(), iconWidget->geometry());
+    iconWidget->setVisible(m_filterNeedle.isEmpty() || iconData->searchKey().contains(m_filterNeedle));
+    qCDebug(lcIcon) << "Adopted IconWidget for IconData ID:" << iconData->id() << "into zone" << (m_zoneData ? m_zoneData->id() : QUuid());
+}
+
+void ZoneWidget::notifyIconDroppedOutside(const QUuid& iconId, const QPoint& globalPos) {
+    if (m_zoneData) {
+        emit iconDroppedOutside(m_zoneData, iconId, globalPos);
+    }
+}
+
 IconWidget* ZoneWidget::findIconWidget(const QUuid& iconId) {
-    for (IconWidget* iw : m_iconWidgets) {
-        if (iw->data() && iw->data()->id() == iconId) {
-            return iw;
+    return m_iconWidgetById.value(iconId, nullptr);
+}
+
+
+// --- Painted Icons ---
+
+void ZoneWidget::setPaintIconsAlways(bool always) {
+    s_paintIconsAlways = always; // Existing zones pick it up in refreshIconRenderMode()
+}
+
+bool ZoneWidget::wantsPaintedIcons() const {
+    if (s_paintIconsAlways) return true;
+    const int count = m_zoneData ? m_zoneData->icons().size() : 0;
+    // Hysteresis, so a zone hovering around the threshold does not rebuild on every add and remove
+    return m_paintedIcons ? count >= PAINTED_ICONS_THRESHOLD / 2 : count >= PAINTED_ICONS_THRESHOLD;
+}
+
+void ZoneWidget::refreshIconRenderMode() {
+    if (wantsPaintedIcons() != m_paintedIcons) {
+        loadOrUpdateIcons();
+    }
+}
+
+void ZoneWidget::switchIconRenderModeIfNeeded() {
+    const bool painted = wantsPaintedIcons();
+    if (painted == m_paintedIcons) return;
+    qCDebug(lcZone) << "Zone" << (m_zoneData ? m_zoneData->id() : QUuid()) << (painted ? "paints" : "creates widgets for")
+                    << (m_zoneData ? m_zoneData->icons().size() : 0) << "icons";
+
+    const QList<IconWidget*> iconWidgets = m_iconWidgets;
+    for (IconWidget* iw : iconWidgets) {
+        destroyIconWidget(iw);
+    }
+    m_iconWidgets.clear();
+    m_iconWidgetById.clear();
+    m_iconIndex.clear();
+    m_iconStackOrder.clear();
+    for (PaintedIconImage& iconImage : m_iconImages) {
+        iconImage.ticket.cancel();
+    }
+    m_iconImages.clear();
+    m_hiddenIconIds.clear();
+    m_hoveredIconId = QUuid();
+    cancelIconDrag();
+    setToolTip(QString());
+    m_paintedIcons = painted; // The selection is kept; the caller rebuilds the icons
+    update();
+}
+
+void ZoneWidget::indexPaintedIcon(IconData* iconData) {
+    if (!iconData) return;
+    const QUuid id = iconData->id();
+    if (!m_iconStackOrder.contains(id)) {
+        m_iconStackOrder.insert(id, ++m_nextIconStackOrder);
+    }
+    if (m_filterNeedle.isEmpty() || iconData->searchKey().contains(m_filterNeedle)) {
+        m_hiddenIconIds.remove(id);
+    } else {
+        m_hiddenIconIds.insert(id);
+    }
+    movePaintedIcon(id, QRect(iconData->positionInZone().toPoint(), IconPainter::tileSize()));
+}
+
+void ZoneWidget::movePaintedIcon(const QUuid& iconId, const QRect& rect) {
+    const QRect oldRect = m_iconIndex.rectOf(iconId); // Null if not indexed yet
+    if (oldRect == rect) return;
+    m_iconIndex.insert(iconId, rect);
+    update(oldRect);
+    update(rect);
+}
+
+void ZoneWidget::removePaintedIcon(const QUuid& iconId) {
+    update(m_iconIndex.rectOf(iconId));
+    m_iconIndex.remove(iconId);
+    m_iconStackOrder.remove(iconId);
+    m_iconImages.take(iconId).ticket.cancel();
+    m_hiddenIconIds.remove(iconId);
+    m_selectedIconIds.remove(iconId);
+    if (m_hoveredIconId == iconId) setHoveredIcon(QUuid());
+    if (m_draggedIconIds.contains(iconId)) cancelIconDrag(); // Removed or sent elsewhere mid-drag
+}
+
+QUuid ZoneWidget::paintedIconAt(const QPoint& pos) const {
+    if (!m_paintedIcons) return QUuid();
+    QUuid topmost;
+    quint64 topmostOrder = 0;
+    const QList<QUuid> hits = m_iconIndex.query(QRect(pos, QSize(1, 1)));
+    for (const QUuid& id : hits) {
+        if (m_hiddenIconIds.contains(id)) continue;
+        const quint64 order = m_iconStackOrder.value(id);
+        if (topmost.isNull() || order > topmostOrder) { // Same order the icons are painted in
+            topmost = id;
+            topmostOrder = order;
+        }
+    }
+    return topmost;
+}
+
+bool ZoneWidget::hasPendingContent() const {
+    if (m_bgDecodePending) return true;
+    for (const PaintedIconImage& iconImage : m_iconImages) {
+        if (iconImage.pending) return true;
+    }
+    for (IconWidget* iconWidget : m_iconWidgets) {
+        if (iconWidget->isFileIconPending()) return true;
+    }
+    return false;
+}
+
+QPixmap ZoneWidget::paintedIconImage(IconData* iconData) {
+    const QUuid id = iconData->id();
+    const qreal dpr = devicePixelRatioF();
+    auto imageIt = m_iconImages.find(id);
+    if (imageIt != m_iconImages.end()) {
+        if (imageIt->filePath == iconData->filePath() && imageIt->devicePixelRatio == dpr) return imageIt->image;
+        imageIt->ticket.cancel(); // Retargeted, or moved to a screen with another scale: resolve again
+    }
+
+    // First time on screen: icons never scrolled into view or filtered out are never resolved
+    FileIconService* service = FileIconService::instance();
+    PaintedIconImage iconImage;
+    iconImage.filePath = iconData->filePath();
+    iconImage.devicePixelRatio = dpr;
+    iconImage.image = service->cachedIcon(iconData->filePath(), IconPainter::imageSize(), dpr);
+    iconImage.pending = iconImage.image.isNull();
+    m_iconImages.insert(id, iconImage); // Before subscribing: a known icon without an image answers at once
+    if (iconImage.pending) {
+        const FileIconTicket ticket = service->subscribe(iconData->filePath(), IconPainter::imageSize(), dpr, this,
+                                                         [this, id](const QPixmap& image) {
+            auto it = m_iconImages.find(id);
+            if (it == m_iconImages.end()) return; // Removed meanwhile
+            it->image = image;
+            it->pending = false;
+            update(m_iconIndex.rectOf(id));
+            notifyContentReady(m_iconIndex.rectOf(id));
+        });
+        m_iconImages[id].ticket = ticket;
+    }
+    return m_iconImages.value(id).image;
+}
+
+void ZoneWidget::setHoveredIcon(const QUuid& iconId) {
+    if (iconId == m_hoveredIconId) return;
+    if (!m_hoveredIconId.isNull()) update(m_iconIndex.rectOf(m_hoveredIconId));
+    m_hoveredIconId = iconId;
+    IconData* icon = (iconId.isNull() || !m_zoneData) ? nullptr : m_zoneData->findIcon(iconId);
+    if (icon) update(m_iconIndex.rectOf(iconId));
+    setToolTip(icon ? icon->filePath() : QString());
+}
+
+QRect ZoneWidget::iconRect(const QUuid& iconId) {
+    if (m_paintedIcons) return m_iconIndex.rectOf(iconId);
+    IconWidget* iw = findIconWidget(iconId);
+    return iw ? iw->geometry() : QRect(); // The widget, not the index: a live drag moves only the widget
+}
+
+bool ZoneWidget::isIconShown(const QUuid& iconId) {
+    if (m_paintedIcons) return m_iconIndex.contains(iconId) && !m_hiddenIconIds.contains(iconId);
+    IconWidget* iw = findIconWidget(iconId);
+    return iw && iw->isVisible();
+}
+
+void ZoneWidget::showIconSelection(const QUuid& iconId, bool selected) {
+    if (m_paintedIcons) {
+        update(m_iconIndex.rectOf(iconId)); // Painted from m_selectedIconIds
+    } else if (IconWidget* iw = findIconWidget(iconId)) {
+        iw->setSelected(selected);
+    }
+}
+
+void ZoneWidget::showPaintedIconMenu(const QUuid& iconId, const QPoint& pos) {
+    if (!m_zoneData || !m_zoneData->findIcon(iconId)) return;
+    // Right-clicking outside the selection makes this icon the selection
+    if (!m_selectedIconIds.contains(iconId)) {
+        clearSelection();
+        setIconSelected(iconId, true);
+    }
+    const int selectedCount = m_selectedIconIds.size();
+
+    QMenu contextMenu(this);
+    if (selectedCount == 1) {
+        QAction *launchAction = contextMenu.addAction("Open");
+        connect(launchAction, &QAction::triggered, this, [this, iconId]() { launchIcon(iconId); });
+        contextMenu.addSeparator();
+    }
+    addSendToZoneMenu(&contextMenu);
+    contextMenu.addSeparator();
+    QAction *removeAction = contextMenu.addAction(selectedCount > 1 ? QString("Remove %1 Selected Icons").arg(selectedCount) : QString("Remove Icon"));
+    connect(removeAction, &QAction::triggered, this, &ZoneWidget::removeSelectedIcons); // Confirms once, single icon included
+    contextMenu.exec(mapToGlobal(pos));
+}
+
+void ZoneWidget::launchIcon(const QUuid& iconId) {
+    IconData* icon = m_zoneData ? m_zoneData->findIcon(iconId) : nullptr;
+    if (!icon || icon->filePath().isEmpty()) {
+        qWarning() << "No file path associated with this icon.";
+        QMessageBox::information(this, "Cannot Open", "No file path is associated with this icon.");
+        return;
+    }
+
+    qCDebug(lcIcon) << "Attempting to launch:" << icon->filePath();
+    if (!QDesktopServices::openUrl(QUrl::fromLocalFile(icon->filePath()))) {
+        qWarning() << "Failed to open URL:" << icon->filePath();
+        QMessageBox::warning(this, "Open Failed",
+                             QString("Could not open the file or application:\n%1\n\nPlease check if the file exists and you have the necessary permissions.").arg(icon->filePath()));
+    }
+}
+
+
+// --- Delta Updates ---
+
+void ZoneWidget::applyIconsMoved(const QList<QUuid>& iconIds) {
+    for (const QUuid& iconId : iconIds) {
+        if (m_paintedIcons) {
+            if (m_iconIndex.contains(iconId) && m_zoneData) indexPaintedIcon(m_zoneData->findIcon(iconId));
+        } else if (IconWidget* iw = findIconWidget(iconId)) {
+            iw->updateFromData();
+            m_iconIndex.insert(iconId, iw->geometry());
+        }
+    }
+}
+
+void ZoneWidget::applyIconsAdded(const QList<QUuid>& iconIds) {
+    if (!m_zoneData) return;
+    if (wantsPaintedIcons() != m_paintedIcons) {
+        loadOrUpdateIcons(); // Crossed the threshold: rebuild in the other mode
+        return;
+    }
+    for (const QUuid& iconId : iconIds) {
+        IconData* iconD = m_zoneData->findIcon(iconId);
+        if (m_paintedIcons) {
+            if (iconD && !m_iconIndex.contains(iconId)) indexPaintedIcon(iconD);
+        } else if (iconD && !m_iconWidgetById.contains(iconId)) {
+            createIconWidget(iconD);
         }
     }
-    return nullptr;
+}
+
+void ZoneWidget::applyIconsRemoved(const QList<QUuid>& iconIds) {
+    for (const QUuid& iconId : iconIds) {
+        if (m_paintedIcons) {
+            removePaintedIcon(iconId);
+            continue;
+        }
+        m_iconIndex.remove(iconId);
+        m_selectedIconIds.remove(iconId);
+        destroyIconWidget(m_iconWidgetById.take(iconId));
+    }
+    if (m_zoneData && wantsPaintedIcons() != m_paintedIcons) {
+        loadOrUpdateIcons(); // Dropped below half the threshold: back to widgets
+    }
+}
+
+void ZoneWidget::applyGeometryChanged() {
+    if (!m_zoneData) return;
+    QRect newGeometry = m_zoneData->geometry().toRect();
+    if (geometry() != newGeometry) {
+        setGeometry(newGeometry); // Resize/move events trigger the repaint
+    }
+}
+
+void ZoneWidget::applyStyleChanged() {
+    // paintEvent notices a changed image path or blur state and reprocesses on its own
+    update();
+    updateShadow(geometry()); // The corner radius shapes the shadow too
+}
+
+void ZoneWidget::applyTitleChanged() {
+    update(0, 0, width(), qMin(20, height())); // Title bar only
+}
+
+void ZoneWidget::applyStacksChanged() {
+    loadOrUpdateStacks();
+}
+
+
+// --- Selection and Bulk Operations ---
+
+QList<QUuid> ZoneWidget::selectedIconIds() const {
+    // Straight from the set: bulk operations cost O(selected), not O(icons in zone)
+    QList<QUuid> ids;
+    if (!m_zoneData) return ids;
+    ids.reserve(m_selectedIconIds.size());
+    for (const QUuid& id : m_selectedIconIds) {
+        if (m_zoneData->findIcon(id)) {
+            ids.append(id);
+        }
+    }
+    return ids;
+}
+
+void ZoneWidget::setIconSelected(const QUuid& iconId, bool selected) {
+    if (m_paintedIcons ? !m_iconIndex.contains(iconId) : !findIconWidget(iconId)) return;
+    if (selected) {
+        m_selectedIconIds.insert(iconId);
+    } else {
+        m_selectedIconIds.remove(iconId);
+    }
+    showIconSelection(iconId, selected);
+}
+
+void ZoneWidget::clearSelection() {
+    for (const QUuid& id : std::as_const(m_selectedIconIds)) {
+        showIconSelection(id, false);
+    }
+    m_selectedIconIds.clear();
+}
+
+void ZoneWidget::selectAllIcons() {
+    if (m_paintedIcons) {
+        if (!m_zoneData) return;
+        for (IconData* icon : m_zoneData->icons()) {
+            if (isIconShown(icon->id())) m_selectedIconIds.insert(icon->id()); // Respect the current filter
+        }
+        update();
+        return;
+    }
+    for (auto it = m_iconWidgetById.constBegin(); it != m_iconWidgetById.constEnd(); ++it) {
+        if (it.value()->isVisible()) { // Respect the current filter
+            m_selectedIconIds.insert(it.key());
+            it.value()->setSelected(true);
+        }
+    }
+}
+
+QList<QUuid> ZoneWidget::snapIconsToGrid(const QList<QUuid>& iconIds, const QPoint& offset) {
+    QList<QUuid> movedIds;
+    if (!m_zoneData) return movedIds;
+    for (const QUuid& id : iconIds) {
+        IconData* icon = m_zoneData->findIcon(id);
+        const QRect rect = iconRect(id).translated(offset);
+        if (!icon || rect.isNull()) continue;
+        const QPointF snapped = snappedIconPosition(rect);
+        const QRect snappedRect(snapped.toPoint(), rect.size());
+        if (m_paintedIcons) {
+            movePaintedIcon(id, snappedRect);
+        } else if (IconWidget* iw = findIconWidget(id)) {
+            iw->move(snappedRect.topLeft());
+            m_iconIndex.insert(id, snappedRect);
+        }
+        if (icon->positionInZone() != snapped) {
+            icon->setPositionInZone(snapped);
+            movedIds.append(id);
+        }
+    }
+    return movedIds;
+}
+
+QPointF ZoneWidget::snappedIconPosition(const QRect& rect) const {
+    QPointF snapped(std::round(rect.x() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE,
+                    std::round(rect.y() / static_cast<qreal>(GRID_SIZE)) * GRID_SIZE);
+    snapped.setX(qBound(0.0, snapped.x(), qMax(0.0, width() - static_cast<qreal>(rect.width()))));
+    snapped.setY(qBound(0.0, snapped.y(), qMax(0.0, height() - static_cast<qreal>(rect.height()))));
+    return snapped;
+}
+
+// --- Icon Dragging ---
+
+void ZoneWidget::beginIconDrag(const QUuid& iconId, const QPoint& pressPos) {
+    cancelIconDrag();
+    const bool groupDrag = m_selectedIconIds.contains(iconId) && m_selectedIconIds.size() > 1;
+    m_draggedIconIds = groupDrag ? selectedIconIds() : QList<QUuid>{iconId};
+    m_iconDragBounds = QRect();
+    for (const QUuid& id : std::as_const(m_draggedIconIds)) {
+        m_iconDragBounds |= iconRect(id);
+    }
+    m_iconDragOffset = pressPos - m_iconDragBounds.topLeft();
+    m_isDraggingIcon = true;
+}
+
+void ZoneWidget::updateIconDrag(const QPoint& globalPos) {
+    if (!m_isDraggingIcon) return;
+    const QPoint pos = mapFromGlobal(globalPos);
+    if (!m_dragGhost) {
+        const QPoint pressPos = m_iconDragBounds.topLeft() + m_iconDragOffset;
+        if ((pos - pressPos).manhattanLength() < QApplication::startDragDistance()) return; // Still a click
+        m_dragGhost = new DragGhost(iconsSnapshot(m_draggedIconIds, m_iconDragBounds), this);
+        qCDebug(lcIcon) << "Dragging" << m_draggedIconIds.size() << "icon(s) from zone" << m_zoneData->id();
+    }
+    m_dragGhost->moveTo(mapToGlobal(iconDragTopLeft(pos)));
+}
+
+void ZoneWidget::finishIconDrag(const QPoint& globalPos) {
+    if (!m_isDraggingIcon) return;
+    const bool dragged = !m_dragGhost.isNull();
+    const QList<QUuid> iconIds = m_draggedIconIds;
+    const QPoint pos = mapFromGlobal(globalPos);
+    const QPoint offset = iconDragTopLeft(pos) - m_iconDragBounds.topLeft(); // Same for every dragged icon
+    cancelIconDrag();
+    if (!dragged || !m_zoneData || !m_pageManager) return; // A click: nothing moved
+
+    if (rect().contains(pos)) {
+        const QList<QUuid> movedIds = snapIconsToGrid(iconIds, offset); // The only move of the whole drag
+        if (!movedIds.isEmpty()) {
+            m_pageManager->notifyIconsMoved(m_zoneData, movedIds); // One delta and one save for the group
+        }
+        return;
+    }
+
+    PageTabContentWidget* pageWidget = qobject_cast<PageTabContentWidget*>(parentWidget());
+    ZoneWidget* targetZoneWidget = pageWidget ? pageWidget->zoneWidgetAt(pageWidget->mapFromGlobal(globalPos)) : nullptr;
+    if (targetZoneWidget && targetZoneWidget != this && targetZoneWidget->data()) {
+        // Dropped on another zone: the icons keep their placement relative to each other
+        const QPoint toTarget = targetZoneWidget->mapFromGlobal(mapToGlobal(QPoint(0, 0)));
+        QList<QPointF> positions;
+        for (const QUuid& id : iconIds) {
+            positions.append(targetZoneWidget->snappedIconPosition(iconRect(id).translated(offset + toTarget)));
+        }
+        // MainWindow hands the widgets over (or the target paints them) when the batch commits
+        m_pageManager->moveIcons(m_zoneData, targetZoneWidget->data(), iconIds, positions);
+    } else if (!targetZoneWidget && iconIds.size() == 1) {
+        notifyIconDroppedOutside(iconIds.first(), globalPos); // Maybe a page tab
+    }
+    // Anywhere else the icons never left their place
+}
+
+void ZoneWidget::cancelIconDrag() {
+    delete m_dragGhost; // Its window closes with it
+    m_dragGhost = nullptr;
+    m_isDraggingIcon = false;
+    m_draggedIconIds.clear();
+}
+
+QPoint ZoneWidget::iconDragTopLeft(const QPoint& pos) const {
+    const QPoint topLeft = pos - m_iconDragOffset;
+    if (!rect().contains(pos)) return topLeft; // Over another zone or a page tab: follows the cursor freely
+    // Inside the zone the bounds are clamped as a whole, so relative placement is preserved
+    return QPoint(qBound(0, topLeft.x(), qMax(0, width() - m_iconDragBounds.width())),
+                  qBound(0, topLeft.y(), qMax(0, height() - m_iconDragBounds.height())));
+}
+
+QPixmap ZoneWidget::iconsSnapshot(const QList<QUuid>& iconIds, const QRect& bounds) {
+    const qreal dpr = devicePixelRatioF();
+    QPixmap snapshot((QSizeF(bounds.size()) * dpr).toSize());
+    snapshot.setDevicePixelRatio(dpr);
+    snapshot.fill(Qt::transparent);
+    if (!m_zoneData) return snapshot;
+
+    // Drawn with the same painter as the tiles, so widget and painted icons give the same ghost
+    QPainter painter(&snapshot);
+    painter.setFont(font());
+    painter.translate(-bounds.topLeft());
+    for (const QUuid& id : iconIds) {
+        IconData* icon = m_zoneData->findIcon(id);
+        if (!icon) continue;
+        const QPixmap image = FileIconService::instance()->cachedIcon(icon->filePath(), IconPainter::imageSize(), dpr);
+        IconPainter::paint(&painter, iconRect(id), icon, image, m_selectedIconIds.contains(id), false);
+    }
+    return snapshot;
+}
+
+void ZoneWidget::removeSelectedIcons() {
+    if (!m_zoneData || !m_pageManager) return;
+    const QList<QUuid> ids = selectedIconIds();
+    if (ids.isEmpty()) return;
+
+    QString question = ids.size() == 1
+        ? QString("Are you sure you want to remove icon '%1'?").arg(m_zoneData->findIcon(ids.first())->displayName())
+        : QString("Are you sure you want to remove %1 selected icons?").arg(ids.size());
+    if (QMessageBox::question(this, "Confirm Remove Icons", question, QMessageBox::Yes|QMessageBox::No) != QMessageBox::Yes) {
+        return;
+    }
+
+    clearSelection();
+    PageManager::BatchScope batch(m_pageManager);
+    QList<QUuid> removedIds;
+    for (const QUuid& id : ids) {
+        if (m_zoneData->removeIcon(id)) {
+            removedIds.append(id);
+        }
+    }
+    qCDebug(lcZone) << "Removed" << removedIds.size() << "selected icons from zone" << m_zoneData->id();
+    m_pageManager->notifyIconsRemoved(m_zoneData, removedIds);
+}
+
+void ZoneWidget::sendSelectedIconsToZone(ZoneData* targetZone) {
+    if (!m_zoneData || !m_pageManager || !targetZone || targetZone == m_zoneData) return;
+    const QList<QUuid> ids = selectedIconIds();
+    if (ids.isEmpty()) return;
+
+    // Keep the icons' arrangement, moved to the target's top-left below its title bar
+    QRectF bounds;
+    for (const QUuid& id : ids) {
+        if (IconData* icon = m_zoneData->findIcon(id)) bounds |= QRectF(icon->positionInZone(), QSizeF(1, 1));
+    }
+    const QPointF offset = QPointF(16, 32) - bounds.topLeft();
+    const QSizeF targetSize = targetZone->geometry().size();
+    const QSizeF iconSize = QSizeF(IconPainter::tileSize());
+
+    QList<QPointF> positions;
+    for (const QUuid& id : ids) {
+        QPointF target = m_zoneData->findIcon(id) ? m_zoneData->findIcon(id)->positionInZone() + offset : QPointF(16, 32);
+        target.setX(qBound(0.0, target.x(), qMax(0.0, targetSize.width() - iconSize.width())));
+        target.setY(qBound(0.0, target.y(), qMax(0.0, targetSize.height() - iconSize.height())));
+        positions.append(target);
+    }
+
+    clearSelection();
+    // One batch across both zones; the widgets are handed over, not recreated
+    const QList<QUuid> movedIds = m_pageManager->moveIcons(m_zoneData, targetZone, ids, positions);
+    qCDebug(lcZone) << "Sent" << movedIds.size() << "icons from zone" << m_zoneData->id() << "to zone" << targetZone->id();
+}
+
+void ZoneWidget::addSendToZoneMenu(QMenu* menu) {
+    if (!m_zoneData || !m_pageManager || m_selectedIconIds.isEmpty()) return;
+
+    QMenu* sendMenu = menu->addMenu(m_selectedIconIds.size() > 1 ? QString("Send %1 Icons to Zone").arg(m_selectedIconIds.size())
+                                                                 : QString("Send to Zone"));
+    for (PageData* page : m_pageManager->pages()) {
+        QMenu* pageMenu = nullptr;
+        for (ZoneData* zone : page->zones()) {
+            if (zone == m_zoneData) continue;
+            if (!pageMenu) pageMenu = sendMenu->addMenu(page->name());
+            QAction* action = pageMenu->addAction(zone->title().isEmpty() ? QString("(Untitled Zone)") : zone->title());
+            const QUuid pageId = page->id();
+            const QUuid zoneId = zone->id();
+            connect(action, &QAction::triggered, this, [this, pageId, zoneId]() {
+                // Look the zone up again: the menu may outlive a zone deleted meanwhile
+                PageData* targetPage = m_pageManager->pageById(pageId);
+                sendSelectedIconsToZone(targetPage ? targetPage->zoneById(zoneId) : nullptr);
+            });
+        }
+    }
+    sendMenu->setEnabled(!sendMenu->isEmpty());
+}
+
+void ZoneWidget::keyPressEvent(QKeyEvent *event)
+{
+    if ((event->key() == Qt::Key_Delete || event->key() == Qt::Key_Backspace) && !m_selectedIconIds.isEmpty()) {
+        removeSelectedIcons();
+        event->accept();
+    } else if (event->key() == Qt::Key_Escape && m_isDraggingIcon) {
+        cancelIconDrag(); // The icons never moved; the release that follows is ignored
+        event->accept();
+    } else if (event->key() == Qt::Key_Escape && !m_selectedIconIds.isEmpty()) {
+        clearSelection();
+        event->accept();
+    } else if (event->matches(QKeySequence::SelectAll)) {
+        selectAllIcons();
+        event->accept();
+    } else {
+        QWidget::keyPressEvent(event);
+    }
 }
 
 
@@ -721,7 +1639,9 @@ void ZoneWidget::dropEvent(QDropEvent *event)
 
     const QMimeData* mimeData = event->mimeData();
     if (mimeData->hasUrls()) {
+        PageManager::BatchScope batch(m_pageManager); // One delta and one save for the whole drop
         QList<QUrl> urls = mimeData->urls();
+        QList<QUuid> addedIconIds;
         for (const QUrl& url : urls) {
             if (url.isLocalFile()) {
                 QString filePath = url.toLocalFile();
@@ -730,6 +1650,7 @@ void ZoneWidget::dropEvent(QDropEvent *event)
                 // Create IconData
                 IconData* newIconData = new IconData(filePath, dropPos);
                 m_zoneData->addIcon(newIconData); // ZoneData now owns IconData
+                addedIconIds.append(newIconData->id());
 
                 // Create IconWidget (or let loadOrUpdateIcons handle it)
                 // IconWidget* newIconWidget = new IconWidget(newIconData, m_pageManager, this);
@@ -738,12 +1659,12 @@ void ZoneWidget::dropEvent(QDropEvent *event)
                 // newIconWidget->raise();
                 // No, better to just update the data and let loadOrUpdateIcons sync
 
-                qDebug() << "Dropped file:" << filePath << "at" << dropPos << "in zone" << m_zoneData->id();
+                qCDebug(lcZone) << "Dropped file:" << filePath << "at" << dropPos << "in zone" << m_zoneData->id();
             }
         }
-        // Notify PageManager that ZoneData has changed (icons added)
-        m_pageManager->updateZoneData(m_zoneData);
-        // loadOrUpdateIcons(); // updateZoneData signal should eventually lead to this via PageTabContentWidget -> ZoneWidget::updateFromData
+        // Notify PageManager that icons were added; the iconsAdded delta comes back
+        // via PageTabContentWidget -> ZoneWidget::applyIconsAdded and creates only the new widgets.
+        m_pageManager->notifyIconsAdded(m_zoneData, addedIconIds);
         event->acceptProposedAction();
     } else {
         event->ignore();
@@ -8,12 +8,24 @@
 #include <QPoint>
 #include <QMenu>
 #include <QList> // For IconWidgets
+#include <QHash>
+#include <QUuid>
 #include <QMimeData> // For drag and drop
+#include <QSet>
+#include <QPointer>
+#include "IconSpatialIndex.h"
+#include "ImageDecodeService.h" // For ImageDecodeTicket
+#include "FileIconService.h"    // For FileIconTicket
+#include "ShadowPainter.h"
 
 class ZoneData;    // Forward declaration
 class PageManager; // Forward declaration for signaling updates
 class IconWidget;  // Forward declaration
 class IconData;    // Forward declaration
+class IconStackWidget; // Forward declaration
+class QRubberBand;     // Forward declaration
+class DragGhost;       // Forward declaration
+class QTimer;          // Forward declaration
 
 class ZoneWidget : public QWidget
 {
@@ -32,8 +44,69 @@ public:
     void updateFromData(); // Update widget appearance AND icons from m_zoneData
     void filterIcons(const QString& filterText); // New method for icon filtering
 
+    // Delta updates, routed from PageManager's typed signals. Each touches only what changed.
+    void applyIconsMoved(const QList<QUuid>& iconIds);
+    void applyIconsAdded(const QList<QUuid>& iconIds);
+    void applyIconsRemoved(const QList<QUuid>& iconIds);
+    void applyGeometryChanged();
+    void applyStyleChanged();
+    void applyTitleChanged();
+    void applyStacksChanged(); // Reconciles stack tiles with ZoneData::stacks()
+
+    // Icons moved between zones keep their widget: the source releases it, the target adopts it
+    IconWidget* releaseIconWidget(const QUuid& iconId); // Unregisters without deleting; null if none
+    void adoptIconWidget(IconData* iconData, IconWidget* iconWidget); // Creates one if iconWidget is null
+    void notifyIconDroppedOutside(const QUuid& iconId, const QPoint& globalPos); // Dropped outside every zone
+
+    // Icon selection (rubber band and ctrl-click). Bulk operations act on the selection.
+    bool isIconSelected(const QUuid& iconId) const { return m_selectedIconIds.contains(iconId); }
+    int selectedIconCount() const { return m_selectedIconIds.size(); }
+    QList<QUuid> selectedIconIds() const;
+    void setIconSelected(const QUuid& iconId, bool selected);
+    void clearSelection();
+    void selectAllIcons();
+    void removeSelectedIcons();                // One confirmation, one batch
+    void sendSelectedIconsToZone(ZoneData* targetZone); // One batch across both zones
+    void addSendToZoneMenu(QMenu* menu);       // "Send to Zone" submenu listing every other zone
+
+    // Icon drags, started by an IconWidget or a painted icon. A ghost of the dragged icons (the whole
+    // selection if the pressed icon is part of it) follows the cursor; the icons stay put and move
+    // once on release, inside this zone or into the zone under the cursor.
+    void beginIconDrag(const QUuid& iconId, const QPoint& pressPos); // pressPos in zone coordinates
+    void updateIconDrag(const QPoint& globalPos);
+    void finishIconDrag(const QPoint& globalPos);
+    void cancelIconDrag(); // Drops the ghost; nothing moves
+
+    // Large zones paint their icons themselves instead of creating one IconWidget per icon.
+    // The zone then does its own hit testing, hover, drag and context menus for them.
+    bool paintsIcons() const { return m_paintedIcons; }
+    void refreshIconRenderMode(); // Switches between widgets and painting if the threshold or preference says so
+    static void setPaintIconsAlways(bool always); // Paint icons in every zone, whatever its size
+    static bool paintIconsAlways() { return s_paintIconsAlways; }
+
+    // Outline resize (the default) shows only a frame while the edge is dragged and resizes the zone
+    // once on release. Live resize follows the cursor, at most once per display frame.
+    static void setOutlineResize(bool outline) { s_outlineResize = outline; }
+    static bool outlineResize() { return s_outlineResize; }
+
+    // The zone's drop shadow lies outside the zone, so the page paints it, under the zones, from a
+    // pre-blurred nine-patch. exposed is in the page's coordinates, like geometry().
+    void paintShadow(QPainter* painter, const QRegion& exposed) const;
+    static QMargins shadowMargins() { return ShadowPainter::margins(shadow()); }
+
+    // Asynchronous content (a decoded background, a resolved file icon) arrived for rect, in zone
+    // coordinates. update() does nothing while the page is hidden, so its render cache listens to this.
+    void notifyContentReady(const QRect& rect) { emit contentReady(rect); } // Also for the icon widgets
+    bool hasPendingContent() const; // A background decode or an icon lookup has not answered yet
+
+signals:
+    void iconDroppedOutside(ZoneData* zoneData, const QUuid& iconId, const QPoint& globalPos);
+    void contentReady(const QRect& rect);
+
 protected:
     void paintEvent(QPaintEvent *event) override;
+    void moveEvent(QMoveEvent *event) override;     // The page repaints the shadow's old and new places
+    void resizeEvent(QResizeEvent *event) override;
     void mousePressEvent(QMouseEvent *event) override;
     void mouseMoveEvent(QMouseEvent *event) override;
     void mouseReleaseEvent(QMouseEvent *event) override;
@@ -41,6 +114,7 @@ protected:
     void leaveEvent(QEvent *event) override;
     void contextMenuEvent(QContextMenuEvent *event) override;
     void mouseDoubleClickEvent(QMouseEvent *event) override; // For title editing
+    void keyPressEvent(QKeyEvent *event) override; // Delete/Escape/Ctrl+A for the selection
     void dragEnterEvent(QDragEnterEvent *event) override;
     void dragMoveEvent(QDragMoveEvent *event) override;
     void dropEvent(QDropEvent *event) override;
@@ -54,25 +128,102 @@ private slots:
     void setBackgroundImageRequested();
     void clearBackgroundImageRequested();
     void toggleBlurBackgroundImageRequested();
+    void collapseIconsIntoStackRequested();
 
 private:
+    static ShadowPainter::Shadow shadow();
+    void updateShadow(const QRect& previousGeometry); // In the page, around previousGeometry and geometry()
     void updateCursorShape(const QPoint& pos);
     ResizeRegion getResizeRegion(const QPoint& pos);
     void handleResize(const QPoint& newMousePos);
+    QRect resizedGeometry(const QPoint& globalPos) const; // Zone geometry for the cursor at globalPos during a resize
     void handleMove(const QPoint& newMousePos);
-    void loadOrUpdateIcons(); // Helper to create/update IconWidgets
+    QPoint movedTopLeft(const QPoint& globalPos) const; // Zone position for the cursor at globalPos during a move
+    void loadOrUpdateIcons(); // Helper to create/update IconWidgets (full reconcile)
+    IconWidget* createIconWidget(IconData* iconData);
+    void destroyIconWidget(IconWidget* iconWidget);
     IconWidget* findIconWidget(const QUuid& iconId);
-    void loadBackgroundImage(); // Helper to load/cache bg image
-    void prepareProcessedBackgroundImage(); // Applies blur if needed
+    bool wantsPaintedIcons() const;
+    void switchIconRenderModeIfNeeded(); // Tears down the old representation; the caller reconciles
+    void indexPaintedIcon(IconData* iconData); // Painted mode: the index holds each icon's drawn rect
+    void movePaintedIcon(const QUuid& iconId, const QRect& rect); // Repaints the old and new rect
+    void removePaintedIcon(const QUuid& iconId);
+    void setHoveredIcon(const QUuid& iconId); // Painted mode: repaints both icons and sets the tooltip
+    QList<QUuid> snapIconsToGrid(const QList<QUuid>& iconIds, const QPoint& offset = QPoint()); // Stores snapped positions; returns the icons that moved
+    QPointF snappedIconPosition(const QRect& rect) const; // On the grid and inside this zone
+    QPoint iconDragTopLeft(const QPoint& pos) const; // Where the dragged icons' bounds go for the cursor at pos
+    QPixmap iconsSnapshot(const QList<QUuid>& iconIds, const QRect& bounds); // Ghost image of the dragged icons
+    QUuid paintedIconAt(const QPoint& pos) const; // Topmost shown icon under pos, or null
+    QPixmap paintedIconImage(IconData* iconData); // Subscribes on the first paint; null until resolved
+    QRect iconRect(const QUuid& iconId); // Painted rect or widget geometry
+    bool isIconShown(const QUuid& iconId); // Exists and is not hidden by the filter
+    void showIconSelection(const QUuid& iconId, bool selected); // Repaints or updates the widget
+    void showPaintedIconMenu(const QUuid& iconId, const QPoint& pos);
+    void launchIcon(const QUuid& iconId);
+    void loadOrUpdateStacks(); // Same reconcile for stack tiles
+    void loadBackgroundImage(); // Requests an asynchronous decode for the current path and blur state
+    void handleBackgroundImageDecoded(const QImage& image);
+    void ensureBackgroundLayer(); // Rebuilds m_backgroundLayer when its key changed
+
+    // Everything the static background layer depends on. A repaint with an unchanged key is one blit.
+    struct BackgroundLayerKey {
+        QSize size;
+        qreal devicePixelRatio = 0;
+        int cornerRadius = -1;
+        QRgb color = 0;
+        qint64 imageCacheKey = 0; // QImage::cacheKey() of m_backgroundImage, 0 without image
+        bool blur = false;
+        bool placeholder = false; // Decode still running for a new path
+
+        bool operator==(const BackgroundLayerKey& other) const {
+            return size == other.size && devicePixelRatio == other.devicePixelRatio && cornerRadius == other.cornerRadius
+                   && color == other.color && imageCacheKey == other.imageCacheKey && blur == other.blur
+                   && placeholder == other.placeholder;
+        }
+        bool operator!=(const BackgroundLayerKey& other) const { return !(*this == other); }
+    };
 
 
     ZoneData* m_zoneData;
     PageManager* m_pageManager; // To notify of changes that need saving
     QList<IconWidget*> m_iconWidgets; // Keep track of icon widgets
-    QPixmap m_cachedBgPixmap;      // Cache for the background image
-    QString m_loadedBgImagePath;   // Path of the currently loaded m_cachedBgPixmap
-    QPixmap m_processedBgPixmap;   // Potentially blurred/tinted version for painting
-    bool m_lastBlurState;          // To detect change in blur state
+    QHash<QUuid, IconWidget*> m_iconWidgetById; // Same widgets keyed by icon ID
+    QHash<QUuid, IconStackWidget*> m_stackWidgetById; // One tile per stack, whatever its size
+    QString m_filterNeedle; // Current lowercase filter, reapplied to tiles created later
+    IconSpatialIndex m_iconIndex; // Loose icon rects, for rubber-band hit testing and, when painted, for drawing
+    bool m_paintedIcons;          // Icons are painted by this widget; m_iconWidgets is empty
+    QSet<QUuid> m_hiddenIconIds;  // Painted mode: icons the filter hides
+    QHash<QUuid, quint64> m_iconStackOrder; // Painted mode: higher draws on top; a dragged icon is raised
+    struct PaintedIconImage {
+        QString filePath;        // With devicePixelRatio, what image was resolved for; a change is a miss
+        qreal devicePixelRatio = 1.0;
+        FileIconTicket ticket;
+        QPixmap image;
+        bool pending = false; // Subscribed and not answered yet
+    };
+    QHash<QUuid, PaintedIconImage> m_iconImages; // Painted mode: only icons painted at least once
+    quint64 m_nextIconStackOrder;
+    QUuid m_hoveredIconId;        // Painted mode
+    bool m_isDraggingIcon;
+    QList<QUuid> m_draggedIconIds; // The pressed icon, or the whole selection it belongs to
+    QRect m_iconDragBounds;       // Their bounding rect when the drag started
+    QPoint m_iconDragOffset;      // Press position relative to m_iconDragBounds
+    QPointer<DragGhost> m_dragGhost; // Icon drag or zone move in progress; null until the cursor leaves the click distance
+    QSet<QUuid> m_selectedIconIds;
+    QSet<QUuid> m_selectionBeforeBand; // Kept while ctrl-extending with the rubber band
+    QRubberBand* m_rubberBand;         // Created on first use
+    QPoint m_selectionOrigin;
+    bool m_isSelecting;
+    QString m_loadedBgImagePath;   // Path last requested from the decode service
+    QImage m_backgroundImage;      // Decoded, possibly blurred; a handle shared with the ImageCache
+    bool m_lastBlurState;          // Blur state last requested, to detect a change
+    bool m_bgDecodePending;        // A decode is running; the placeholder shows if there is no image yet
+    QSize m_bgRequestedSize;       // Device size the last decode covers; growing past it re-decodes
+    ImageDecodeTicket m_bgDecodeTicket;
+    QPixmap m_backgroundLayer;     // Color, scaled image, rounded mask and border at device resolution
+    BackgroundLayerKey m_backgroundLayerKey;
+    QFont m_titleBaseFont;         // Widget font the title font was derived from
+    QFont m_titleFont;
 
     bool m_isResizing;
     bool m_isMoving;
@@ -80,8 +231,16 @@ private:
     QPoint m_mousePressPosition; // Global position at mouse press
     QRectF m_originalGeometry;   // Geometry at start of resize/move
     ResizeRegion m_currentResizeRegion;
+    QPointer<QRubberBand> m_resizeOutline; // Outline resize: a top-level frame, so the page never repaints under it
+    QTimer* m_resizeThrottle;    // Live resize: one setGeometry per display frame
+    QRect m_pendingResizeGeometry; // Live resize: latest geometry the cursor asked for
 
     static const int RESIZE_BORDER_SENSITIVITY = 10; // Pixels for resize handles
+    static const int PAINTED_ICONS_THRESHOLD = 150; // Icon count from which a zone paints its icons; back to widgets below half
+    static const int GRID_SIZE = 16; // Snapping grid for dropped icons
+    static bool s_paintIconsAlways;
+    static bool s_outlineResize;
+    static const int BLUR_RADIUS = 4; // Box radius per pass; three passes are close to the old 8px effect blur
 };
 
 #endif // ZONEWIDGET_H
@@ -1,14 +1,30 @@
 #include <QApplication>
 #include "MainWindow.h"
+#include "Logging.h"
+#include "BlurEngine.h"
+#include <QTextStream>
 
 int main(int argc, char *argv[])
 {
     QApplication a(argc, argv);
 
+    // It's important to set OrganizationName and ApplicationName for QSettings and the log paths
+    QCoreApplication::setOrganizationName("MyCompany"); // Replace as needed
+    QCoreApplication::setApplicationName("DesktopOverlay");
+    LogRing::install(); // Before anything logs, so the ring sees startup too
+
     // Enable high DPI scaling for sharper visuals on relevant displays
     QApplication::setAttribute(Qt::AA_EnableHighDpiScaling);
     QApplication::setAttribute(Qt::AA_UseHighDpiPixmaps);
 
+    if (QCoreApplication::arguments().contains("--benchmark-blur")) {
+        // Prints blur throughput for every kernel this CPU supports, then exits
+        QTextStream out(stdout);
+        out << "Blur kernel: " << BlurEngine::pathName(BlurEngine::bestPath()) << "\n";
+        out << BlurEngine::formatBenchmark(BlurEngine::benchmark());
+        return 0;
+    }
+
     MainWindow w;
     w.show();
 